@@ -0,0 +1,57 @@
+#!/bin/sh
+#
+# VeriFrog benchmark
+#
+# Generates synthetic sources of several shapes and compiles
+# each of them with every data file format. The statistics of
+# each compilation are appended to results-<revision>.jsonl in
+# the output directory, one JSON object per line, so the files
+# of two revisions can be compared.
+#
+# usage: run.sh <vf> <vfgen> <output dir>
+#
+# Zach Baldwin
+# 2026-10-17
+
+set -e
+
+VF=$1
+VFGEN=$2
+OUT=$3
+RUNS=${BENCH_RUNS:-3}
+
+if [ -z "$VF" ] || [ -z "$VFGEN" ] || [ -z "$OUT" ]; then
+    echo "usage: $0 <vf> <vfgen> <output dir>" >&2
+    exit 1
+fi
+
+mkdir -p "$OUT"
+REV=$(git rev-parse --short HEAD 2>/dev/null || echo local)
+RESULTS="$OUT/results-$REV.jsonl"
+rm -f "$RESULTS"
+
+# name: vfgen options
+CASES="
+narrow:-i 4 -o 4 -w 1 -W 16 -t 200000 -e 50 -l 4
+wide:-i 16 -o 16 -w 256 -W 512 -t 5000 -e 50 -l 4
+dense:-i 8 -o 8 -w 8 -W 64 -t 50000 -e 100 -l 64
+sparse:-i 8 -o 8 -w 8 -W 64 -t 50000 -e 2 -l 4
+literal:-i 4 -o 4 -w 1 -W 16 -t 1000 -e 50 -l 4 -L 8000000
+"
+
+echo "$CASES" | while IFS=: read -r name opts; do
+    [ -n "$name" ] || continue
+    # shellcheck disable=SC2086
+    "$VFGEN" $opts > "$OUT/$name.vfl"
+    for fmt in bin hex raw rle chg; do
+        run=0
+        while [ $run -lt "$RUNS" ]; do
+            "$VF" -q -f $fmt -S "$RESULTS" "$OUT/$name.vfl" \
+                  "$OUT/$name.dat" "$OUT/tb_$name.v"
+            run=$((run + 1))
+        done
+    done
+    echo "$name done"
+done
+
+echo "Results in $RESULTS"
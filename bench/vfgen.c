@@ -0,0 +1,195 @@
+/**
+ * VeriFrog synthetic source generator
+ *
+ * Writes a .vfl file of a given shape to stdout for
+ * benchmarking the compiler. The same options and seed
+ * always give the same file.
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <getopt.h>
+
+// Shape of the generated source
+typedef struct gen_opts_t {
+	unsigned int inputs;
+	unsigned int outputs;
+	unsigned int min_width;
+	unsigned int max_width;
+	unsigned long ticks;
+	unsigned int density;           // Percent of sets followed by an expect
+	unsigned int lookahead;         // Largest expect delay
+	unsigned long literal;          // Bytes of literal text
+	uint64_t seed;
+} gen_opts_t;
+
+static uint64_t _rand(uint64_t *s);
+static void _write_value(unsigned int width, uint64_t *s);
+static void usage(const char *prog);
+
+static const char hex_digits[] = "0123456789abcdef";
+
+
+int main(int argc, char *argv[])
+{
+    gen_opts_t o = {4, 4, 1, 32, 10000, 50, 4, 0, 1};
+    unsigned int *in_w, *out_w;
+    uint64_t s;
+    unsigned long t, n;
+    unsigned int i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:o:w:W:t:e:l:L:r:h")) != -1) {
+        switch (opt) {
+        case 'i': o.inputs = strtoul(optarg, NULL, 10); break;
+        case 'o': o.outputs = strtoul(optarg, NULL, 10); break;
+        case 'w': o.min_width = strtoul(optarg, NULL, 10); break;
+        case 'W': o.max_width = strtoul(optarg, NULL, 10); break;
+        case 't': o.ticks = strtoul(optarg, NULL, 10); break;
+        case 'e': o.density = strtoul(optarg, NULL, 10); break;
+        case 'l': o.lookahead = strtoul(optarg, NULL, 10); break;
+        case 'L': o.literal = strtoul(optarg, NULL, 10); break;
+        case 'r': o.seed = strtoull(optarg, NULL, 10); break;
+        case 'h':
+            usage(argv[0]);
+            exit(EXIT_SUCCESS);
+        default:
+            usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!o.inputs || !o.outputs || !o.min_width || o.max_width < o.min_width ||
+        !o.lookahead || o.density > 100) {
+        fprintf(stderr, "ERROR: invalid shape\n");
+        exit(EXIT_FAILURE);
+    }
+
+    in_w = malloc(sizeof(*in_w) * o.inputs);
+    out_w = malloc(sizeof(*out_w) * o.outputs);
+    if (!in_w || !out_w) {
+        fprintf(stderr, "ERROR: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // A zero state would stay zero
+    s = o.seed ? o.seed : 1;
+
+    printf("// Generated by vfgen -i %u -o %u -w %u -W %u -t %lu -e %u -l %u -L %lu -r %llu\n",
+           o.inputs, o.outputs, o.min_width, o.max_width, o.ticks, o.density,
+           o.lookahead, o.literal, (unsigned long long)o.seed);
+    printf("use tick clk 10 ns\nmodule bench\n\n");
+    for (i = 0; i < o.inputs; ++i) {
+        in_w[i] = o.min_width + _rand(&s) % (o.max_width - o.min_width + 1);
+        printf("input in%u %u\n", i, in_w[i]);
+    }
+    for (i = 0; i < o.outputs; ++i) {
+        out_w[i] = o.min_width + _rand(&s) % (o.max_width - o.min_width + 1);
+        printf("output out%u %u\n", i, out_w[i]);
+    }
+
+    // Literal text in lines of 64 characters
+    if (o.literal) {
+        printf("\n%%{{\n");
+        for (n = 0; n < o.literal; n += 64) {
+            printf("// %060lu\n", n);
+        }
+        printf("%%}}\n");
+    }
+
+    printf("\n");
+    for (t = 0; t < o.ticks; ++t) {
+        printf("set {");
+        for (i = 0; i < o.inputs; ++i) {
+            printf(" in%u = ", i);
+            _write_value(in_w[i], &s);
+            printf(";");
+        }
+        printf(" }\n");
+
+        if (_rand(&s) % 100 < o.density) {
+            printf("expect (%u) {", (unsigned int)(1 + _rand(&s) % o.lookahead));
+            for (i = 0; i < o.outputs; ++i) {
+                printf(" out%u = ", i);
+                _write_value(out_w[i], &s);
+                printf(";");
+            }
+            printf(" }\n");
+        }
+    }
+
+    free(in_w);
+    free(out_w);
+    return fflush(stdout) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+/**
+ * Get the next number of an xorshift64 sequence
+ *
+ * @param *s The state of the sequence
+ * @return The number
+ */
+static uint64_t _rand(uint64_t *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+
+/**
+ * Write a random hex constant of a given width
+ *
+ * @param width The width of the constant
+ * @param *s The state of the random sequence
+ * @return none
+ */
+static void _write_value(unsigned int width, uint64_t *s)
+{
+    unsigned int digits = (width + 3) / 4;
+    unsigned int top = width % 4;
+    uint64_t r = 0;
+    unsigned int i;
+
+    printf("%u'h", width);
+    for (i = 0; i < digits; ++i) {
+        if (i % 16 == 0) {
+            r = _rand(s);
+        }
+        // The leading digit only has the bits left over
+        putchar(hex_digits[(i == 0 && top) ? (r & ((1u << top) - 1)) : (r & 0xf)]);
+        r >>= 4;
+    }
+}
+
+
+/**
+ * Print the command line usage
+ *
+ * @param *prog The name of the executable
+ * @return none
+ */
+static void usage(const char *prog)
+{
+    printf("\
+Usage: %s [options] > out.vfl\n\
+\n\
+Options:\n\
+  -i N   Number of inputs (default 4)\n\
+  -o N   Number of outputs (default 4)\n\
+  -w N   Smallest port width (default 1)\n\
+  -W N   Largest port width (default 32)\n\
+  -t N   Number of ticks, one set each (default 10000)\n\
+  -e N   Percent of sets followed by an expect (default 50)\n\
+  -l N   Largest expect delay in ticks (default 4)\n\
+  -L N   Bytes of literal text (default 0)\n\
+  -r N   Random seed (default 1)\n\
+  -h     Show this message\n\
+",
+           prog);
+}
@@ -0,0 +1,170 @@
+/**
+ * VeriFrog region allocator
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+// Space taken at the start of every block by its header
+#define ARENA_HEADER_SIZE \
+    ((sizeof(arena_block_t) + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1))
+
+static arena_block_t *_arena_new_block(arena_t *a, size_t size);
+
+
+/**
+ * Initialize an empty arena
+ * 
+ * @param **a Pointer to the arena to be allocated
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+int arena_init(arena_t **a)
+{
+    (*a) = malloc(sizeof(**a));
+    if (!(*a)) {
+        return 1;
+    }
+    (*a)->head = NULL;
+    (*a)->cur = NULL;
+    (*a)->total = 0;
+    (*a)->allocs = 0;
+    return 0;
+}
+
+
+/**
+ * Allocate memory from an arena. The memory is aligned
+ * to ARENA_ALIGN bytes and is not initialized.
+ * 
+ * @param *a The arena to allocate from
+ * @param size Number of bytes to allocate
+ * @return Pointer to the memory, NULL on allocation failure
+ */
+void *arena_alloc(arena_t *a, size_t size)
+{
+    arena_block_t *b = a->cur;
+    void *p;
+
+    size = (size + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1);
+
+    // Move on to the next block (kept from before a reset)
+    // or add a new one when the current block is full
+    while (!b || b->used + size > b->size) {
+        if (b && b->n) {
+            b = b->n;
+            b->used = ARENA_HEADER_SIZE;
+        } else {
+            b = _arena_new_block(a, size);
+            if (!b) {
+                return NULL;
+            }
+        }
+    }
+    a->cur = b;
+
+    p = (char *)b + b->used;
+    b->used += size;
+    ++a->allocs;
+    return p;
+}
+
+
+/**
+ * Copy a string into an arena
+ * 
+ * @param *a The arena to allocate from
+ * @param *s The string to copy (need not be null terminated)
+ * @param len The number of characters to copy
+ * @return The null terminated copy, NULL on allocation failure
+ */
+char *arena_strndup(arena_t *a, const char *s, size_t len)
+{
+    char *str = arena_alloc(a, len + 1);
+    if (str) {
+        memcpy(str, s, len);
+        str[len] = '\0';
+    }
+    return str;
+}
+
+
+/**
+ * Release all allocations of an arena at once. The blocks
+ * are kept and reused by later allocations.
+ * 
+ * @param *a The arena to reset
+ * @return none
+ */
+void arena_reset(arena_t *a)
+{
+    a->cur = a->head;
+    if (a->head) {
+        a->head->used = ARENA_HEADER_SIZE;
+    }
+}
+
+
+/**
+ * Free an arena and all memory allocated from it. *a will
+ * be NULL following the operation.
+ * 
+ * @param **a Pointer to the arena to be free'd
+ * @return none
+ */
+void arena_destroy(arena_t **a)
+{
+    arena_block_t *b, *n;
+    
+    if (!a || !(*a)) {
+        return;
+    }
+    for (b = (*a)->head; b; b = n) {
+        n = b->n;
+        free(b);
+    }
+    free(*a);
+    *a = NULL;
+}
+
+
+/**
+ * Allocate a block large enough for an allocation and
+ * link it after the current block
+ * 
+ * @param *a The arena to add the block to
+ * @param size The size of the allocation that must fit
+ * @return The new block, NULL on allocation failure
+ */
+static arena_block_t *_arena_new_block(arena_t *a, size_t size)
+{
+    size_t bsize = ARENA_BLOCK_SIZE;
+    arena_block_t *b;
+
+    if (size + ARENA_HEADER_SIZE > bsize) {
+        bsize = size + ARENA_HEADER_SIZE;
+    }
+    b = malloc(bsize);
+    if (!b) {
+        return NULL;
+    }
+    b->used = ARENA_HEADER_SIZE;
+    b->size = bsize;
+    a->total += bsize;
+
+    // Insert after the current block so that blocks kept
+    // from before a reset are still reached
+    if (a->cur) {
+        b->n = a->cur->n;
+        a->cur->n = b;
+    } else {
+        b->n = a->head;
+        a->head = b;
+    }
+    return b;
+}
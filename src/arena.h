@@ -0,0 +1,40 @@
+/**
+ * VeriFrog region allocator header
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_ARENA_H
+#define VERIFROG_ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE 65536
+#define ARENA_ALIGN 16
+
+typedef struct arena_block_t {
+	struct arena_block_t *n;
+	size_t used;
+	size_t size;
+} arena_block_t;
+
+/*
+ * Allocations are carved sequentially out of large blocks
+ * and are only released all at once, either by resetting
+ * the arena (blocks are kept for reuse) or destroying it.
+ */
+typedef struct arena_t {
+	arena_block_t *head;    // First block
+	arena_block_t *cur;     // Block currently allocated from
+	size_t total;           // Bytes held in all blocks
+	unsigned long allocs;   // Number of allocations made
+} arena_t;
+
+int arena_init(arena_t **a);
+void *arena_alloc(arena_t *a, size_t size);
+char *arena_strndup(arena_t *a, const char *s, size_t len);
+void arena_reset(arena_t *a);
+void arena_destroy(arena_t **a);
+
+#endif
@@ -0,0 +1,406 @@
+/**
+ * VeriFrog batch compilation
+ *
+ * Compiles many input files on a pool of worker threads.
+ * The jobs are dealt out to per-worker deques, largest
+ * input first. A worker takes jobs from the front of its
+ * own deque and, once it is empty, steals from the back
+ * of the other workers' deques so that a few large inputs
+ * do not leave the other workers idle.
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "verifrog.h"
+#include "batch.h"
+
+#define BATCH_INITIAL_SIZE 16
+#define BATCH_LINE_SIZE 4096
+
+// Job indices of one worker. No jobs are added once the
+// workers are started so the deque only ever shrinks.
+typedef struct batch_deque_t {
+	pthread_mutex_t lock;
+	unsigned int *items;
+	unsigned int head;              // Next job of the owner
+	unsigned int tail;              // One past the next job to steal
+} batch_deque_t;
+
+typedef struct batch_worker_t {
+	pthread_t thread;
+	unsigned int id;
+	unsigned int nworkers;
+	int running;                    // Thread was started
+	struct batch_worker_t *all;
+	batch_deque_t q;
+	vf_batch_t *batch;
+} batch_worker_t;
+
+static int _batch_default_names(vf_job_t *j);
+static int _batch_cmp_size(const void *a, const void *b);
+static void *_batch_worker(void *arg);
+static int _deque_take(batch_deque_t *q);
+static int _deque_steal(batch_deque_t *q);
+
+
+/**
+ * Add an input file to a batch. Data and test bench file
+ * names default to the input name with a .dat extension
+ * and to tb_<name>.v next to it.
+ *
+ * @param *b The batch to add to
+ * @param *input The input file name
+ * @param *dat The data file name or NULL for the default
+ * @param *tb The test bench file name or NULL for the default
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+int batch_add(vf_batch_t *b, const char *input, const char *dat, const char *tb) {
+
+    vf_job_t *j;
+    struct stat st;
+
+    if (b->count == b->size) {
+        unsigned int size = b->size ? b->size * 2 : BATCH_INITIAL_SIZE;
+        vf_job_t *jobs = realloc(b->jobs, sizeof(*jobs) * size);
+        if (!jobs) {
+            return 1;
+        }
+        b->jobs = jobs;
+        b->size = size;
+    }
+
+    j = &(b->jobs[b->count]);
+    memset(j, 0, sizeof(*j));
+    j->input_file = strdup(input);
+    if (!j->input_file) {
+        return 1;
+    }
+    if (dat && tb) {
+        j->dat_file = strdup(dat);
+        j->tb_file = strdup(tb);
+    } else if (_batch_default_names(j) == 0 && dat) {
+        free(j->dat_file);
+        j->dat_file = strdup(dat);
+    }
+    if (!j->dat_file || !j->tb_file) {
+        free(j->input_file);
+        free(j->dat_file);
+        free(j->tb_file);
+        return 1;
+    }
+
+    // Missing files still get a job so that their error
+    // is reported with the others
+    j->size = stat(input, &st) ? 0 : (long)st.st_size;
+    ++b->count;
+    return 0;
+}
+
+
+/**
+ * Add all inputs listed in a manifest file to a batch.
+ * Each line has the same form as the command line:
+ *   <input.vfl> [data file] [test bench file]
+ * Blank lines and text after a '#' are ignored.
+ *
+ * @param *b The batch to add to
+ * @param *path The manifest file name
+ * @return 0 on success
+ *         1 on failure (the reason has been printed)
+ */
+int batch_add_manifest(vf_batch_t *b, const char *path) {
+
+    FILE *f;
+    char line[BATCH_LINE_SIZE];
+    char *args[3], *p, *save;
+    unsigned int n, lnum = 0;
+
+    f = fopen(path, "r");
+    if (!f) {
+        DIAG(NULL, DIAG_ERROR, DIAG_CAT_BATCH, "unable to open manifest '%s'", path);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), f)) {
+        ++lnum;
+        if ((p = strchr(line, '#'))) {
+            *p = '\0';
+        }
+
+        n = 0;
+        for (p = strtok_r(line, " \t\r\n", &save); p;
+             p = strtok_r(NULL, " \t\r\n", &save)) {
+            if (n == 3) {
+                DIAG(NULL, DIAG_ERROR, DIAG_CAT_BATCH,
+                     "too many file names on line %u of manifest '%s'",
+                     lnum, path);
+                fclose(f);
+                return 1;
+            }
+            args[n++] = p;
+        }
+        if (n == 0) {
+            continue;
+        }
+
+        if (batch_add(b, args[0], n > 1 ? args[1] : NULL, n > 2 ? args[2] : NULL)) {
+            DIAG(NULL, DIAG_ERROR, DIAG_CAT_BATCH, "unable to allocate batch job");
+            fclose(f);
+            return 1;
+        }
+    }
+
+    fclose(f);
+    return 0;
+}
+
+
+/**
+ * Compile all inputs of a batch. Each input is compiled
+ * on its own context so a failing input does not stop
+ * the others.
+ *
+ * @param *b The batch to compile
+ * @param workers The number of worker threads. 0 uses one
+ *                worker per online processor
+ * @return The number of inputs that failed to compile
+ */
+unsigned int batch_run(vf_batch_t *b, unsigned int workers) {
+
+    batch_worker_t *w;
+    unsigned int i, k, failed = 0;
+    long ncpu;
+
+    if (!b->count) {
+        return 0;
+    }
+
+    if (!workers) {
+        ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = ncpu > 0 ? (unsigned int)ncpu : 1;
+    }
+    if (workers > b->count) {
+        workers = b->count;
+    }
+
+    // Start the largest inputs first
+    qsort(b->jobs, b->count, sizeof(*(b->jobs)), _batch_cmp_size);
+
+    w = calloc(workers, sizeof(*w));
+    if (!w) {
+        DIAG(NULL, DIAG_ERROR, DIAG_CAT_BATCH, "unable to allocate batch workers");
+        return b->count;
+    }
+
+    // Deal the jobs out round robin so every worker gets
+    // a mix of large and small inputs
+    for (i = 0; i < workers; ++i) {
+        w[i].id = i;
+        w[i].nworkers = workers;
+        w[i].all = w;
+        w[i].batch = b;
+        w[i].q.items = malloc(sizeof(*(w[i].q.items)) *
+                              ((b->count + workers - 1) / workers));
+        if (!w[i].q.items) {
+            DIAG(NULL, DIAG_ERROR, DIAG_CAT_BATCH, "unable to allocate batch workers");
+            for (k = 0; k < i; ++k) {
+                free(w[k].q.items);
+            }
+            free(w);
+            return b->count;
+        }
+        pthread_mutex_init(&(w[i].q.lock), NULL);
+    }
+    for (i = 0; i < b->count; ++i) {
+        batch_deque_t *q = &(w[i % workers].q);
+        q->items[q->tail++] = i;
+    }
+
+    // The calling thread is worker 0
+    for (i = 1; i < workers; ++i) {
+        if (pthread_create(&(w[i].thread), NULL, _batch_worker, &(w[i]))) {
+            // Its jobs get stolen by the running workers
+            DIAG(NULL, DIAG_WARN, DIAG_CAT_BATCH, "unable to start batch worker %u", i);
+        } else {
+            w[i].running = 1;
+        }
+    }
+    _batch_worker(&(w[0]));
+    for (i = 1; i < workers; ++i) {
+        if (w[i].running) {
+            pthread_join(w[i].thread, NULL);
+        }
+    }
+
+    for (i = 0; i < workers; ++i) {
+        pthread_mutex_destroy(&(w[i].q.lock));
+        free(w[i].q.items);
+    }
+    free(w);
+
+    for (i = 0; i < b->count; ++i) {
+        if (b->jobs[i].status) {
+            DIAG(NULL, DIAG_ERROR, DIAG_CAT_BATCH,
+                 "failed to compile '%s'", b->jobs[i].input_file);
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+
+/**
+ * Free all jobs of a batch
+ *
+ * @param *b The batch to free
+ * @return none
+ */
+void batch_free(vf_batch_t *b) {
+    unsigned int i;
+    for (i = 0; i < b->count; ++i) {
+        free(b->jobs[i].input_file);
+        free(b->jobs[i].dat_file);
+        free(b->jobs[i].tb_file);
+    }
+    free(b->jobs);
+    b->jobs = NULL;
+    b->count = 0;
+    b->size = 0;
+}
+
+
+/**
+ * Run jobs until no worker has any left
+ *
+ * @param *arg The batch_worker_t of this thread
+ * @return NULL
+ */
+static void *_batch_worker(void *arg) {
+
+    batch_worker_t *w = arg;
+    vf_batch_t *b = w->batch;
+    vf_job_t *j;
+    vf_ctx_t ctx;
+    unsigned int i;
+    int k;
+
+    for (;;) {
+        k = _deque_take(&(w->q));
+
+        // Own deque is empty, steal from the others
+        for (i = 1; k < 0 && i < w->nworkers; ++i) {
+            k = _deque_steal(&(w->all[(w->id + i) % w->nworkers].q));
+        }
+        if (k < 0) {
+            return NULL;
+        }
+
+        j = &(b->jobs[k]);
+        vf_ctx_init(&ctx);
+        ctx.input_file = j->input_file;
+        ctx.dat_file = j->dat_file;
+        ctx.tb_file = j->tb_file;
+        ctx.dat_format = b->dat_format;
+        ctx.stream = b->stream;
+        ctx.sparse = b->sparse;
+        ctx.stamp = b->stamp;
+        ctx.cache_dir = b->cache_dir;
+        ctx.stats_text = b->stats_text;
+        ctx.stats_file = b->stats_file;
+
+        // The workers already keep the processors busy, so
+        // module blocks are written on this thread
+        ctx.threads = 1;
+        j->status = vf_compile(&ctx);
+    }
+}
+
+
+/**
+ * Take the next job from the front of a deque
+ *
+ * @param *q The deque of the calling worker
+ * @return The job index or -1 if the deque is empty
+ */
+static int _deque_take(batch_deque_t *q) {
+    int k = -1;
+    pthread_mutex_lock(&(q->lock));
+    if (q->head != q->tail) {
+        k = q->items[q->head++];
+    }
+    pthread_mutex_unlock(&(q->lock));
+    return k;
+}
+
+
+/**
+ * Steal a job from the back of another worker's deque.
+ * The back holds that worker's smallest remaining input.
+ *
+ * @param *q The deque to steal from
+ * @return The job index or -1 if the deque is empty
+ */
+static int _deque_steal(batch_deque_t *q) {
+    int k = -1;
+    pthread_mutex_lock(&(q->lock));
+    if (q->head != q->tail) {
+        k = q->items[--q->tail];
+    }
+    pthread_mutex_unlock(&(q->lock));
+    return k;
+}
+
+
+/**
+ * Order jobs by decreasing input size
+ */
+static int _batch_cmp_size(const void *a, const void *b) {
+    long sa = ((const vf_job_t *)a)->size;
+    long sb = ((const vf_job_t *)b)->size;
+    return (sa < sb) - (sa > sb);
+}
+
+
+/**
+ * Derive the output file names of a job from its input:
+ * dir/name.vfl -> dir/name.dat and dir/tb_name.v
+ *
+ * @param *j The job whose names to set
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+static int _batch_default_names(vf_job_t *j) {
+
+    char *stem, *base, *dot;
+
+    stem = strdup(j->input_file);
+    if (!stem) {
+        return 1;
+    }
+
+    base = strrchr(stem, '/');
+    base = base ? base + 1 : stem;
+    dot = strrchr(base, '.');
+    if (dot && dot != base) {
+        *dot = '\0';
+    }
+
+    j->dat_file = malloc(strlen(stem) + sizeof(".dat"));
+    j->tb_file = malloc(strlen(stem) + sizeof("tb_.v"));
+    if (j->dat_file && j->tb_file) {
+        sprintf(j->dat_file, "%s.dat", stem);
+        sprintf(j->tb_file, "%.*stb_%s.v", (int)(base - stem), stem, base);
+    }
+
+    free(stem);
+    return !j->dat_file || !j->tb_file;
+}
@@ -0,0 +1,41 @@
+/**
+ * VeriFrog batch compilation header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_BATCH_H
+#define VERIFROG_BATCH_H
+
+#include "verifrog.h"
+
+// One input file and the outputs generated from it
+typedef struct vf_job_t {
+	char *input_file;
+	char *dat_file;
+	char *tb_file;
+	long size;                      // Input size, larger files are started first
+	int status;                     // Result of vf_compile()
+} vf_job_t;
+
+// All inputs of a batch and the options shared by them
+typedef struct vf_batch_t {
+	vf_job_t *jobs;
+	unsigned int count;
+	unsigned int size;
+	dat_format_t dat_format;
+	int stream;
+	int sparse;
+	int stamp;
+	const char *cache_dir;
+	int stats_text;
+	const char *stats_file;
+} vf_batch_t;
+
+int batch_add(vf_batch_t *b, const char *input, const char *dat, const char *tb);
+int batch_add_manifest(vf_batch_t *b, const char *path);
+unsigned int batch_run(vf_batch_t *b, unsigned int workers);
+void batch_free(vf_batch_t *b);
+
+#endif
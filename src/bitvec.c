@@ -0,0 +1,498 @@
+/**
+ * VeriFrog packed bit vector
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitvec.h"
+
+static void _bitvec_put_word(bitvec_t *dst, int pos, uint64_t val, int bits);
+static uint64_t _bitvec_get_word(const bitvec_t *bv, int pos, int bits);
+static int _bitvec_from_pow2(bitvec_t *bv, const char *text, int len, int bits);
+static int _bitvec_from_dec(bitvec_t *bv, const char *text, int len);
+static int _bitvec_put_digits(bitvec_t *bv, int *wi, uint64_t val);
+
+// Binary text of each nibble value, MSB first
+static const char bin_nibbles[16][4] = {
+    {'0','0','0','0'}, {'0','0','0','1'}, {'0','0','1','0'}, {'0','0','1','1'},
+    {'0','1','0','0'}, {'0','1','0','1'}, {'0','1','1','0'}, {'0','1','1','1'},
+    {'1','0','0','0'}, {'1','0','0','1'}, {'1','0','1','0'}, {'1','0','1','1'},
+    {'1','1','0','0'}, {'1','1','0','1'}, {'1','1','1','0'}, {'1','1','1','1'}
+};
+
+// Value of each digit character of a binary, octal,
+// decimal or hex constant
+static const unsigned char digit_vals[128] = {
+    ['0'] = 0, ['1'] = 1, ['2'] = 2, ['3'] = 3, ['4'] = 4,
+    ['5'] = 5, ['6'] = 6, ['7'] = 7, ['8'] = 8, ['9'] = 9,
+    ['A'] = 10, ['B'] = 11, ['C'] = 12, ['D'] = 13, ['E'] = 14, ['F'] = 15,
+    ['a'] = 10, ['b'] = 11, ['c'] = 12, ['d'] = 13, ['e'] = 14, ['f'] = 15
+};
+
+// Decimal digits converted per multiply, 10^9 < 2^32
+#define BITVEC_DEC_CHUNK 9
+
+static const uint32_t dec_pows[BITVEC_DEC_CHUNK + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+
+/**
+ * Allocate a bit vector with all bits cleared
+ * 
+ * @param width The number of bits in the vector
+ * @return The new vector, NULL on allocation failure
+ */
+bitvec_t *bitvec_create(int width)
+{
+    bitvec_t *bv = malloc(sizeof(*bv));
+    if (!bv) {
+        return NULL;
+    }
+    bv->width = width;
+    bv->nwords = BITVEC_WORDS(width);
+    bv->w = calloc(bv->nwords ? bv->nwords : 1, sizeof(*(bv->w)));
+    if (!bv->w) {
+        free(bv);
+        return NULL;
+    }
+    return bv;
+}
+
+
+/**
+ * Allocate a bit vector with all bits cleared from an
+ * arena. The vector is released with the arena and must
+ * not be passed to bitvec_destroy().
+ * 
+ * @param *a The arena to allocate from
+ * @param width The number of bits in the vector
+ * @return The new vector, NULL on allocation failure
+ */
+bitvec_t *bitvec_alloc(arena_t *a, int width)
+{
+    bitvec_t *bv = arena_alloc(a, sizeof(*bv));
+    if (!bv) {
+        return NULL;
+    }
+    bv->width = width;
+    bv->nwords = BITVEC_WORDS(width);
+    bv->w = arena_alloc(a, sizeof(*(bv->w)) * (bv->nwords ? bv->nwords : 1));
+    if (!bv->w) {
+        return NULL;
+    }
+    bitvec_clear(bv);
+    return bv;
+}
+
+
+/**
+ * Free a bit vector. *bv will be NULL following the
+ * operation.
+ * 
+ * @param **bv Pointer to the vector to be free'd
+ * @return none
+ */
+void bitvec_destroy(bitvec_t **bv)
+{
+    if (bv && *bv) {
+        free((*bv)->w);
+        free(*bv);
+        *bv = NULL;
+    }
+}
+
+
+/**
+ * Clear all bits of a vector
+ * 
+ * @param *bv The vector to clear
+ * @return none
+ */
+void bitvec_clear(bitvec_t *bv)
+{
+    memset(bv->w, 0, sizeof(*(bv->w)) * bv->nwords);
+}
+
+
+/**
+ * Set or clear a single bit
+ * 
+ * @param *bv The vector to modify
+ * @param bit Index of the bit (0 = LSB)
+ * @param val 0 to clear the bit, set otherwise
+ * @return none
+ */
+void bitvec_set_bit(bitvec_t *bv, int bit, int val)
+{
+    uint64_t m = (uint64_t)1 << (bit % BITVEC_WORD_BITS);
+    if (val) {
+        bv->w[bit / BITVEC_WORD_BITS] |= m;
+    } else {
+        bv->w[bit / BITVEC_WORD_BITS] &= ~m;
+    }
+}
+
+
+/**
+ * Get a single bit
+ * 
+ * @param *bv The vector to read
+ * @param bit Index of the bit (0 = LSB)
+ * @return The bit value (0 or 1)
+ */
+int bitvec_get_bit(const bitvec_t *bv, int bit)
+{
+    return (bv->w[bit / BITVEC_WORD_BITS] >> (bit % BITVEC_WORD_BITS)) & 1;
+}
+
+
+/**
+ * Copy all bits of src into dst starting at the given
+ * bit offset of dst. Works a word at a time.
+ * 
+ * @param *dst The vector to write into
+ * @param offset Bit position in dst of the LSB of src
+ * @param *src The vector to copy
+ * @return none
+ */
+void bitvec_insert(bitvec_t *dst, int offset, const bitvec_t *src)
+{
+    bitvec_insert_words(dst, offset, src->w, src->width);
+}
+
+
+/**
+ * Copy packed words into dst starting at the given bit
+ * offset of dst. Works a word at a time.
+ * 
+ * @param *dst The vector to write into
+ * @param offset Bit position in dst of the LSB of w
+ * @param *w Packed bits, LSB first (BITVEC_WORDS(width) words)
+ * @param width Number of bits to copy
+ * @return none
+ */
+void bitvec_insert_words(bitvec_t *dst, int offset, const uint64_t *w, int width)
+{
+    int i, bits;
+    for (i = 0; width > 0; ++i) {
+        bits = width > BITVEC_WORD_BITS ? BITVEC_WORD_BITS : width;
+        _bitvec_put_word(dst, offset + (i * BITVEC_WORD_BITS), w[i], bits);
+        width -= bits;
+    }
+}
+
+
+/**
+ * Compare a range of a vector with packed words. Works a
+ * word at a time.
+ * 
+ * @param *bv The vector to compare
+ * @param offset Bit position in bv of the LSB of w
+ * @param *w Packed bits, LSB first (BITVEC_WORDS(width) words)
+ * @param width Number of bits to compare
+ * @return 1 if the bits are the same, 0 otherwise
+ */
+int bitvec_equal_words(const bitvec_t *bv, int offset, const uint64_t *w, int width)
+{
+    uint64_t mask;
+    int i, bits;
+    for (i = 0; width > 0; ++i) {
+        bits = width > BITVEC_WORD_BITS ? BITVEC_WORD_BITS : width;
+        mask = (bits == BITVEC_WORD_BITS) ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1);
+        if (_bitvec_get_word(bv, offset + (i * BITVEC_WORD_BITS), bits) != (w[i] & mask)) {
+            return 0;
+        }
+        width -= bits;
+    }
+    return 1;
+}
+
+
+/**
+ * Set or clear a range of bits. Works a word at a time.
+ * 
+ * @param *dst The vector to write into
+ * @param offset Bit position of the first bit to modify
+ * @param width Number of bits to modify
+ * @param val 0 to clear the bits, set otherwise
+ * @return none
+ */
+void bitvec_fill(bitvec_t *dst, int offset, int width, int val)
+{
+    uint64_t w = val ? ~(uint64_t)0 : 0;
+    int bits;
+    while (width > 0) {
+        bits = width > BITVEC_WORD_BITS ? BITVEC_WORD_BITS : width;
+        _bitvec_put_word(dst, offset, w, bits);
+        offset += bits;
+        width -= bits;
+    }
+}
+
+
+/**
+ * Convert a vector to an ASCII binary string, MSB first
+ * 
+ * @param *bv The vector to convert
+ * @param *out Buffer of at least width characters. It is
+ *             NOT null terminated.
+ * @return Pointer to the character after the last one written
+ */
+char *bitvec_to_bin(const bitvec_t *bv, char *out)
+{
+    int i = bv->width;
+
+    // Leading bits that do not make up a whole nibble
+    while (i % 4) {
+        --i;
+        *out++ = '0' | bitvec_get_bit(bv, i);
+    }
+
+    // Whole nibbles (never straddle a word boundary)
+    while (i > 0) {
+        i -= 4;
+        memcpy(out,
+               bin_nibbles[(bv->w[i / BITVEC_WORD_BITS] >> (i % BITVEC_WORD_BITS)) & 0xf],
+               4);
+        out += 4;
+    }
+    return out;
+}
+
+
+/**
+ * Convert a vector to an ASCII hex string, MSB first.
+ * The top digit is zero extended if the width is not a
+ * multiple of 4.
+ * 
+ * @param *bv The vector to convert
+ * @param *out Buffer of at least (width + 3) / 4
+ *             characters. It is NOT null terminated.
+ * @return Pointer to the character after the last one written
+ */
+char *bitvec_to_hex(const bitvec_t *bv, char *out)
+{
+    static const char hex_digits[16] = "0123456789abcdef";
+    int i = ((bv->width + 3) / 4) * 4;
+
+    while (i > 0) {
+        i -= 4;
+        *out++ = hex_digits[(bv->w[i / BITVEC_WORD_BITS] >> (i % BITVEC_WORD_BITS)) & 0xf];
+    }
+    return out;
+}
+
+
+/**
+ * Convert a vector to raw bytes, most significant byte
+ * first (the order in which $fread fills a reg). The top
+ * byte is zero extended if the width is not a multiple
+ * of 8.
+ * 
+ * @param *bv The vector to convert
+ * @param *out Buffer of at least (width + 7) / 8 bytes
+ * @return Pointer to the byte after the last one written
+ */
+char *bitvec_to_bytes(const bitvec_t *bv, char *out)
+{
+    int i = ((bv->width + 7) / 8) * 8;
+
+    while (i > 0) {
+        i -= 8;
+        *out++ = (char)((bv->w[i / BITVEC_WORD_BITS] >> (i % BITVEC_WORD_BITS)) & 0xff);
+    }
+    return out;
+}
+
+
+/**
+ * Set a vector to the value of the digits of a constant.
+ * The digits must be valid for the base.
+ *
+ * @param *bv The vector to set
+ * @param *text The digits, most significant first
+ * @param len Number of digits
+ * @param base 2, 8, 10 or 16
+ * @return 0 on success
+ *         1 if the value does not fit in the width of bv
+ */
+int bitvec_from_text(bitvec_t *bv, const char *text, int len, int base)
+{
+    int err;
+
+    bitvec_clear(bv);
+    switch (base) {
+    case 2:  err = _bitvec_from_pow2(bv, text, len, 1); break;
+    case 8:  err = _bitvec_from_pow2(bv, text, len, 3); break;
+    case 16: err = _bitvec_from_pow2(bv, text, len, 4); break;
+    default: err = _bitvec_from_dec(bv, text, len); break;
+    }
+
+    // Bits above the width are only set by values that are
+    // too wide
+    if (!err && bv->width % BITVEC_WORD_BITS &&
+        bv->w[bv->nwords - 1] >> (bv->width % BITVEC_WORD_BITS)) {
+        err = 1;
+    }
+    return err;
+}
+
+
+/**
+ * Write the low bits of a word into a vector at any bit
+ * position. The value may straddle two words of dst.
+ * 
+ * @param *dst The vector to write into
+ * @param pos Bit position of the LSB of val
+ * @param val The bits to write
+ * @param bits Number of bits of val to write (1 - 64)
+ * @return none
+ */
+static void _bitvec_put_word(bitvec_t *dst, int pos, uint64_t val, int bits)
+{
+    uint64_t mask = (bits == BITVEC_WORD_BITS) ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1);
+    int wi = pos / BITVEC_WORD_BITS;
+    int sh = pos % BITVEC_WORD_BITS;
+
+    val &= mask;
+    dst->w[wi] = (dst->w[wi] & ~(mask << sh)) | (val << sh);
+    if (sh && sh + bits > BITVEC_WORD_BITS) {
+        dst->w[wi + 1] = (dst->w[wi + 1] & ~(mask >> (BITVEC_WORD_BITS - sh)))
+            | (val >> (BITVEC_WORD_BITS - sh));
+    }
+}
+
+
+/**
+ * Read bits of a vector at any bit position into the low
+ * bits of a word. The bits may straddle two words of bv.
+ * 
+ * @param *bv The vector to read
+ * @param pos Bit position of the first bit to read
+ * @param bits Number of bits to read (1 - 64)
+ * @return The bits, the upper bits of the word are clear
+ */
+static uint64_t _bitvec_get_word(const bitvec_t *bv, int pos, int bits)
+{
+    uint64_t mask = (bits == BITVEC_WORD_BITS) ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1);
+    int wi = pos / BITVEC_WORD_BITS;
+    int sh = pos % BITVEC_WORD_BITS;
+    uint64_t val = bv->w[wi] >> sh;
+
+    if (sh && sh + bits > BITVEC_WORD_BITS) {
+        val |= bv->w[wi + 1] << (BITVEC_WORD_BITS - sh);
+    }
+    return val & mask;
+}
+
+
+/**
+ * Convert binary, octal or hex digits. The digits are read
+ * from the least significant one and packed into whole
+ * words.
+ *
+ * @param *bv The cleared vector to set
+ * @param *text The digits, most significant first
+ * @param len Number of digits
+ * @param bits Bits per digit (1, 3 or 4)
+ * @return 0 on success
+ *         1 if the value does not fit in the words of bv
+ */
+static int _bitvec_from_pow2(bitvec_t *bv, const char *text, int len, int bits)
+{
+    const char *p = text + len;
+    uint64_t acc = 0, v;
+    int n = 0, wi = 0;
+
+    while (p != text) {
+        v = digit_vals[*--p & 0x7f];
+        acc |= v << n;
+        n += bits;
+        if (n >= BITVEC_WORD_BITS) {
+            if (_bitvec_put_digits(bv, &wi, acc)) {
+                return 1;
+            }
+            n -= BITVEC_WORD_BITS;
+            acc = n ? v >> (bits - n) : 0;
+        }
+    }
+    return n ? _bitvec_put_digits(bv, &wi, acc) : 0;
+}
+
+
+/**
+ * Convert decimal digits. The vector is multiplied by 10^9
+ * and the next nine digits are added, one 32 bit half word
+ * at a time so no product overflows.
+ *
+ * @param *bv The cleared vector to set
+ * @param *text The digits, most significant first
+ * @param len Number of digits
+ * @return 0 on success
+ *         1 if the value does not fit in the words of bv
+ */
+static int _bitvec_from_dec(bitvec_t *bv, const char *text, int len)
+{
+    uint64_t carry, lo, hi, mul;
+    int i, k, n;
+
+    // Leading zeros do not change the value
+    while (len && *text == '0') {
+        ++text;
+        --len;
+    }
+
+    // The first chunk takes the digits left over by the
+    // whole chunks after it
+    n = len % BITVEC_DEC_CHUNK;
+    if (!n) {
+        n = BITVEC_DEC_CHUNK;
+    }
+    while (len) {
+        mul = dec_pows[n];
+        carry = 0;
+        for (k = 0; k < n; ++k) {
+            carry = carry * 10 + digit_vals[text[k] & 0x7f];
+        }
+        text += n;
+        len -= n;
+
+        for (i = 0; i < bv->nwords; ++i) {
+            lo = (bv->w[i] & 0xffffffffULL) * mul + carry;
+            hi = (bv->w[i] >> 32) * mul + (lo >> 32);
+            bv->w[i] = (hi << 32) | (lo & 0xffffffffULL);
+            carry = hi >> 32;
+        }
+        if (carry) {
+            return 1;
+        }
+        n = BITVEC_DEC_CHUNK;
+    }
+    return 0;
+}
+
+
+/**
+ * Store the next word of a converted constant
+ *
+ * @param *bv The vector being set
+ * @param *wi Index of the word, advanced past it
+ * @param val The word
+ * @return 0 on success
+ *         1 if a set word is past the end of bv
+ */
+static int _bitvec_put_digits(bitvec_t *bv, int *wi, uint64_t val)
+{
+    if (*wi < bv->nwords) {
+        bv->w[*wi] = val;
+    } else if (val) {
+        return 1;
+    }
+    ++(*wi);
+    return 0;
+}
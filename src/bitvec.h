@@ -0,0 +1,44 @@
+/**
+ * VeriFrog packed bit vector header
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_BITVEC_H
+#define VERIFROG_BITVEC_H
+
+#include <stdint.h>
+
+#include "arena.h"
+
+#define BITVEC_WORD_BITS 64
+#define BITVEC_WORDS(width) (((width) + BITVEC_WORD_BITS - 1) / BITVEC_WORD_BITS)
+
+/*
+ * Bits are packed LSB first: bit i of the vector is
+ * bit (i % 64) of word (i / 64). Bits of the last word
+ * above 'width' are always kept clear.
+ */
+typedef struct bitvec_t {
+	int width;      // Number of bits in the vector
+	int nwords;     // Number of words in w
+	uint64_t *w;    // Packed bits
+} bitvec_t;
+
+bitvec_t *bitvec_create(int width);
+bitvec_t *bitvec_alloc(arena_t *a, int width);
+void bitvec_destroy(bitvec_t **bv);
+void bitvec_clear(bitvec_t *bv);
+void bitvec_set_bit(bitvec_t *bv, int bit, int val);
+int bitvec_get_bit(const bitvec_t *bv, int bit);
+void bitvec_insert(bitvec_t *dst, int offset, const bitvec_t *src);
+void bitvec_insert_words(bitvec_t *dst, int offset, const uint64_t *w, int width);
+int bitvec_equal_words(const bitvec_t *bv, int offset, const uint64_t *w, int width);
+void bitvec_fill(bitvec_t *dst, int offset, int width, int val);
+int bitvec_from_text(bitvec_t *bv, const char *text, int len, int base);
+char *bitvec_to_bin(const bitvec_t *bv, char *out);
+char *bitvec_to_hex(const bitvec_t *bv, char *out);
+char *bitvec_to_bytes(const bitvec_t *bv, char *out);
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * VeriFrog compile cache
+ *
+ * The outputs of a compilation only depend on the input
+ * text, the compiler version, the options and the output
+ * file names (which appear in the test bench). These are
+ * hashed into a key and the data, expect and test bench
+ * files are kept as <key>.dat, <key>.exp and <key>.v in
+ * the cache directory. The files the input imports are
+ * only known once it is parsed, so they are listed with
+ * the hashes of their text in <key>.dep and an entry is
+ * only used while they are unchanged.
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "verifrog.h"
+#include "outfile.h"
+#include "input.h"
+#include "import.h"
+#include "cache.h"
+
+static uint64_t _hash_str(uint64_t h, const char *s);
+static char *_cache_path(struct vf_ctx_t *ctx, uint64_t key, const char *ext);
+static int _deps_match(const char *dep);
+static int _write_deps(struct vf_ctx_t *ctx, const char *dep);
+
+
+/**
+ * Compute the cache key of a compilation
+ *
+ * @param *ctx The compilation context (options, file names
+ *             and input set)
+ * @param *key Set to the key
+ * @return 0 on success
+ */
+int cache_key(vf_ctx_t *ctx, uint64_t *key) {
+
+    uint64_t h = CACHE_FNV_OFFSET;
+    unsigned char opts[3];
+
+    h = _hash_str(h, VF_VERSION);
+    opts[0] = (unsigned char)ctx->dat_format;
+    opts[1] = (unsigned char)ctx->stream;
+    opts[2] = (unsigned char)ctx->sparse;
+    h = cache_hash(h, opts, sizeof(opts));
+    h = _hash_str(h, ctx->input_file);
+    h = _hash_str(h, ctx->dat_file);
+    h = _hash_str(h, ctx->tb_file);
+    h = cache_hash(h, ctx->input.buf, ctx->input.size);
+
+    *key = h;
+    return 0;
+}
+
+
+/**
+ * Write the outputs of a compilation from the cache. Output
+ * files whose content does not change are not touched.
+ *
+ * @param *ctx The compilation context
+ * @param key The key from cache_key()
+ * @return 0 on a hit (outputs written)
+ *         1 on a miss
+ */
+int cache_fetch(vf_ctx_t *ctx, uint64_t key) {
+
+    char *dat, *xpct, *dep, *tb;
+    struct stat st;
+    int miss = 1;
+
+    dat = _cache_path(ctx, key, "dat");
+    xpct = _cache_path(ctx, key, "exp");
+    dep = _cache_path(ctx, key, "dep");
+    tb = _cache_path(ctx, key, "v");
+
+    // The test bench is stored last so if it exists the
+    // entry is complete
+    if (dat && xpct && dep && tb && !stat(tb, &st) && _deps_match(dep) &&
+        !outfile_copy(dat, ctx->dat_file) &&
+        (!ctx->sparse || !outfile_copy(xpct, ctx->xpct_file)) &&
+        !outfile_copy(tb, ctx->tb_file)) {
+        miss = 0;
+    }
+
+    free(dat);
+    free(xpct);
+    free(dep);
+    free(tb);
+    return miss;
+}
+
+
+/**
+ * Add the outputs of a successful compilation to the cache.
+ * Failing to do so is not an error.
+ *
+ * @param *ctx The compilation context
+ * @param key The key from cache_key()
+ * @return none
+ */
+void cache_store(vf_ctx_t *ctx, uint64_t key) {
+
+    char *dat, *xpct, *dep, *tb;
+
+    if (mkdir(ctx->cache_dir, 0777) && errno != EEXIST) {
+        DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_MAIN,
+             "unable to create cache directory '%s'", ctx->cache_dir);
+        return;
+    }
+
+    dat = _cache_path(ctx, key, "dat");
+    xpct = _cache_path(ctx, key, "exp");
+    dep = _cache_path(ctx, key, "dep");
+    tb = _cache_path(ctx, key, "v");
+
+    if (!dat || !xpct || !dep || !tb ||
+        outfile_copy(ctx->dat_file, dat) ||
+        (ctx->sparse && outfile_copy(ctx->xpct_file, xpct)) ||
+        _write_deps(ctx, dep) ||
+        outfile_copy(ctx->tb_file, tb)) {
+        DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_MAIN,
+             "unable to store '%s' in the cache", ctx->input_file);
+    }
+
+    free(dat);
+    free(xpct);
+    free(dep);
+    free(tb);
+}
+
+
+/**
+ * Check that the imports listed in a dependency file have
+ * not changed
+ *
+ * @param *dep The dependency file
+ * @return 1 if all imports have the listed hashes
+ *         0 otherwise (or the file is missing)
+ */
+static int _deps_match(const char *dep) {
+
+    FILE *f;
+    char *line = NULL, *path, *nl;
+    size_t size = 0;
+    unsigned long long hash;
+    input_t in;
+    int match = 1;
+
+    f = fopen(dep, "r");
+    if (!f) {
+        return 0;
+    }
+
+    // Each line is <hash> <path>
+    while (match && getline(&line, &size, f) > 0) {
+        hash = strtoull(line, &path, 16);
+        if (*path++ != ' ') {
+            match = 0;
+            break;
+        }
+        if ((nl = strchr(path, '\n'))) {
+            *nl = '\0';
+        }
+        if (input_open(&in, path)) {
+            match = 0;
+        } else {
+            match = cache_hash(CACHE_FNV_OFFSET, in.buf, in.size) == hash;
+            input_close(&in);
+        }
+    }
+    if (ferror(f)) {
+        match = 0;
+    }
+
+    free(line);
+    fclose(f);
+    return match;
+}
+
+
+/**
+ * Write the dependency file of a cache entry
+ *
+ * @param *ctx The compilation context
+ * @param *dep The dependency file
+ * @return 0 on success
+ *         1 on failure
+ */
+static int _write_deps(vf_ctx_t *ctx, const char *dep) {
+
+    outfile_t o;
+    import_t *imp;
+
+    if (!outfile_open(&o, dep)) {
+        return 1;
+    }
+    for (imp = ctx->imports; imp; imp = imp->n) {
+        fprintf(o.f, "%016llx %s\n", (unsigned long long)imp->hash, imp->path);
+    }
+    return outfile_close(&o);
+}
+
+
+/**
+ * Add bytes to an FNV-1a hash
+ *
+ * @param h The hash so far, CACHE_FNV_OFFSET to start
+ * @param *p The bytes
+ * @param len The number of bytes
+ * @return The new hash
+ */
+uint64_t cache_hash(uint64_t h, const void *p, size_t len) {
+    const unsigned char *c = p;
+    while (len--) {
+        h ^= *c++;
+        h *= CACHE_FNV_PRIME;
+    }
+    return h;
+}
+
+
+/**
+ * Get the path of a cache entry file
+ *
+ * @param *ctx The compilation context
+ * @param key The key of the entry
+ * @param *ext The file extension
+ * @return The malloc'd path or NULL on failure
+ */
+static char *_cache_path(vf_ctx_t *ctx, uint64_t key, const char *ext) {
+    char *p = malloc(strlen(ctx->cache_dir) + strlen(ext) + 19);
+    if (p) {
+        sprintf(p, "%s/%016llx.%s", ctx->cache_dir, (unsigned long long)key, ext);
+    }
+    return p;
+}
+
+
+/**
+ * Add a string, including its terminator, to an FNV-1a hash
+ */
+static uint64_t _hash_str(uint64_t h, const char *s) {
+    return cache_hash(h, s, strlen(s) + 1);
+}
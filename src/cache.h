@@ -0,0 +1,26 @@
+/**
+ * VeriFrog compile cache header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_CACHE_H
+#define VERIFROG_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// FNV-1a 64 bit
+#define CACHE_FNV_OFFSET 0xcbf29ce484222325ULL
+#define CACHE_FNV_PRIME 0x100000001b3ULL
+
+struct vf_ctx_t;
+
+uint64_t cache_hash(uint64_t h, const void *p, size_t len);
+
+int cache_key(struct vf_ctx_t *ctx, uint64_t *key);
+int cache_fetch(struct vf_ctx_t *ctx, uint64_t key);
+void cache_store(struct vf_ctx_t *ctx, uint64_t key);
+
+#endif
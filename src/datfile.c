@@ -0,0 +1,591 @@
+/**
+ * VeriFrog data file generation
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "hashtable.h"
+#include "bitvec.h"
+#include "literal.h"
+#include "verifrog.h"
+#include "event.h"
+#include "symbol.h"
+#include "schedule.h"
+#include "gen.h"
+#include "datfile.h"
+
+static void _write_u32(FILE *of, unsigned int v);
+static void _put_u32(unsigned char *b, unsigned int v);
+static int _row_outputs(vf_ctx_t *ctx);
+static size_t _row_size(vf_ctx_t *ctx);
+static int _datfile_map(vf_ctx_t *ctx);
+static void _rle_row(datfile_t *d, char *end);
+static void _rle_flush(datfile_t *d);
+static int _chg_record(vf_ctx_t *ctx, event_t *e);
+static void _chg_value(datfile_t *d, unsigned int index, uint64_t *w, int width);
+static void _xpct_record(vf_ctx_t *ctx);
+
+
+/**
+ * Start generation of the scheduled event table file.
+ * The widths of the rows are fixed at this point.
+ *
+ * @param *ctx The compilation context
+ * @param *of File pointer to output file
+ * @param *xf File pointer to the sparse expect file, NULL
+ *            if the expects are part of the rows
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+int datfile_open(vf_ctx_t *ctx, FILE *of, FILE *xf) {
+
+    datfile_t *d = &(ctx->dat);
+    int outputs = xf ? 0 : ctx->output_offset;
+
+    DIAG(&(ctx->diag), DIAG_INFO, DIAG_CAT_DATFILE,
+         "Tick = %d %s (%s)", ctx->tick_size, ctx->tick_units, ctx->clock_net);
+
+    // Buffers for input and output bit vectors
+    // Note that the set (input) buffer is not reset
+    // after each tick whereas the expect (output)
+    // buffer is. This means signals stay at their set
+    // values until the programmer says otherwise.
+    // Expect values must be explicitly declared in
+    // each expect block
+    d->input_bv  = bitvec_create(ctx->input_offset);
+    d->output_bv = bitvec_create(ctx->output_offset);
+    d->output_mask = bitvec_create(ctx->output_offset);
+
+    // Whole row (mask, outputs, inputs) for formats that
+    // do not separate the fields
+    d->row_bv = bitvec_create((outputs * 2) + ctx->input_offset);
+
+    // Text of one row: mask_out_in\n
+    d->row_text = malloc(sizeof(*(d->row_text)) *
+                         ((ctx->output_offset * 2) + ctx->input_offset + 4));
+    if (ctx->dat_format == DAT_FMT_RLE) {
+        d->run_text = malloc(sizeof(*(d->run_text)) *
+                             ((ctx->output_offset * 2) + ctx->input_offset + 4));
+    }
+    if (!d->input_bv || !d->output_bv || !d->output_mask ||
+        !d->row_bv || !d->row_text ||
+        (ctx->dat_format == DAT_FMT_RLE && !d->run_text)) {
+        datfile_close(ctx);
+        return 1;
+    }
+
+    d->of = of;
+    d->xf = xf;
+    d->rows = 0;
+    d->run = 0;
+    d->idle = 0;
+
+    // Raw records are preceded by a header giving the
+    // field widths. The row count is filled in when the
+    // file is closed.
+    if (ctx->dat_format == DAT_FMT_RAW) {
+        fwrite(DATFILE_RAW_MAGIC, 1, 4, d->of);
+        _write_u32(d->of, ctx->input_offset);
+        _write_u32(d->of, outputs);
+        _write_u32(d->of, 0);
+    }
+    return 0;
+}
+
+
+/**
+ * Returns if the data file has been opened with datfile_open()
+ *
+ * @param *ctx The compilation context
+ * @return 1 if rows can be emitted, 0 otherwise
+ */
+int datfile_is_open(vf_ctx_t *ctx) {
+    return ctx->dat.of != NULL;
+}
+
+
+/**
+ * Write the rows of all ticks in the schedule below the
+ * given tick and free their events. Ticks below the
+ * current tick can no longer be modified by the parser
+ * so this may be called during parsing.
+ *
+ * @param *ctx The compilation context
+ * @param tick The first tick that is NOT written
+ * @return none
+ */
+void datfile_emit(vf_ctx_t *ctx, int tick) {
+
+    // Go through all events and output them to the file
+    datfile_t *d = &(ctx->dat);
+    event_t *e;
+    symbol_t *s;
+    assign_t *a;
+    unsigned int k;
+    char *t, *p;
+    while(!schedule_is_empty(ctx->schedule) &&
+          schedule_first_tick(ctx->schedule) < tick) {
+
+        // Expand repeat blocks up to this tick
+        gen_run(ctx, schedule_first_tick(ctx->schedule));
+
+        // Reset the expect and mask vectors
+        bitvec_clear(d->output_bv);
+        bitvec_clear(d->output_mask);
+
+        // Empty ticks have no event but still generate a row
+        e = schedule_pop(ctx->schedule);
+        if (!e) {
+            ++ctx->stats.empty_ticks;
+        }
+
+        // Change lists are written from the event as the
+        // inputs must be compared before they are updated
+        if (ctx->dat_format == DAT_FMT_CHG && !(e && _chg_record(ctx, e))) {
+            ++d->idle;
+        }
+
+        if (e) {
+
+            DIAG(&(ctx->diag), DIAG_TRACE, DIAG_CAT_DATFILE, "@ %d ticks", e->tick);
+            for (k = 0; k < e->sets.count; ++k) {
+                a = &(e->sets.a[k]);
+                s = ctx->input_syms.syms[a->sym];
+                DIAG(&(ctx->diag), DIAG_TRACE, DIAG_CAT_DATFILE,
+                     "  S - %s; --> %d, %d",
+                     s->sym, s->offset, s->width);
+
+                // Set the bits in the bit vectors
+                bitvec_insert_words(d->input_bv, s->offset, e->vals + a->slot, s->width);
+            }
+            for (k = 0; k < e->xpcts.count; ++k) {
+                a = &(e->xpcts.a[k]);
+                s = ctx->output_syms.syms[a->sym];
+                DIAG(&(ctx->diag), DIAG_TRACE, DIAG_CAT_DATFILE, "  E - %s;", s->sym);
+
+                // Set the bits in the bit vectors
+                bitvec_insert_words(d->output_bv, s->offset, e->vals + a->slot, s->width);
+
+                // Set the bits in the expect mask
+                bitvec_fill(d->output_mask, s->offset, s->width, 1);
+            }
+
+            // Only ticks with expects are in the expect file
+            if (d->xf && e->xpcts.count) {
+                _xpct_record(ctx);
+            }
+
+            // Give the event back for reuse
+            schedule_release(ctx->schedule, e);
+        }
+
+        if (ctx->dat_format == DAT_FMT_CHG) {
+            ++d->rows;
+            continue;
+        }
+
+        // Only convert to text when writing the row.
+        // Mapped rows are converted in place.
+        t = d->map ? d->map + d->map_pos : d->row_text;
+        switch (ctx->dat_format) {
+        case DAT_FMT_HEX:
+            bitvec_insert(d->row_bv, 0, d->input_bv);
+            if (!d->xf) {
+                bitvec_insert(d->row_bv, ctx->input_offset, d->output_bv);
+                bitvec_insert(d->row_bv, ctx->input_offset + ctx->output_offset,
+                              d->output_mask);
+            }
+            p = bitvec_to_hex(d->row_bv, t);
+            *p++ = '\n';
+            break;
+
+        case DAT_FMT_RAW:
+            bitvec_insert(d->row_bv, 0, d->input_bv);
+            if (!d->xf) {
+                bitvec_insert(d->row_bv, ctx->input_offset, d->output_bv);
+                bitvec_insert(d->row_bv, ctx->input_offset + ctx->output_offset,
+                              d->output_mask);
+            }
+            p = bitvec_to_bytes(d->row_bv, t);
+            break;
+
+        case DAT_FMT_RLE:
+        case DAT_FMT_BIN:
+        default:
+            p = t;
+            if (!d->xf) {
+                p = bitvec_to_bin(d->output_mask, p);
+                *p++ = '_';
+                p = bitvec_to_bin(d->output_bv, p);
+                *p++ = '_';
+            }
+            p = bitvec_to_bin(d->input_bv, p);
+            *p++ = '\n';
+            break;
+        }
+        if (d->map) {
+            d->map_pos = p - d->map;
+        } else if (ctx->dat_format == DAT_FMT_RLE) {
+            _rle_row(d, p);
+        } else {
+            fwrite(t, sizeof(*t), p - t, d->of);
+        }
+        ++d->rows;
+    }
+}
+
+
+/**
+ * Write all remaining scheduled ticks and release the
+ * row buffers. Does not close the output file itself.
+ *
+ * @param *ctx The compilation context
+ * @return none
+ */
+void datfile_close(vf_ctx_t *ctx) {
+
+    datfile_t *d = &(ctx->dat);
+
+    if (d->of) {
+        datfile_emit(ctx, schedule_last_tick(ctx->schedule) + 1);
+        _rle_flush(d);
+
+        // Trailing idle ticks still need an empty record
+        // so that the test bench does not run out of file
+        if (d->idle) {
+            fprintf(d->of, "%u 0 0\n", d->idle - 1);
+            d->idle = 0;
+        }
+
+        // Patch the row count into the header
+        if (d->map) {
+            if (ctx->dat_format == DAT_FMT_RAW) {
+                _put_u32((unsigned char *)d->map + DATFILE_RAW_ROWS_POS, d->rows);
+            }
+            munmap(d->map, d->map_size);
+            d->map = NULL;
+            fseek(d->of, 0, SEEK_END);
+        } else if (ctx->dat_format == DAT_FMT_RAW) {
+            fseek(d->of, DATFILE_RAW_ROWS_POS, SEEK_SET);
+            _write_u32(d->of, d->rows);
+            fseek(d->of, 0, SEEK_END);
+        }
+    }
+    if (d->map) {
+        munmap(d->map, d->map_size);
+        d->map = NULL;
+    }
+
+    bitvec_destroy(&(d->input_bv));
+    bitvec_destroy(&(d->output_bv));
+    bitvec_destroy(&(d->output_mask));
+    bitvec_destroy(&(d->row_bv));
+    free(d->row_text);
+    free(d->run_text);
+    d->row_text = NULL;
+    d->run_text = NULL;
+    d->of = NULL;
+    d->xf = NULL;
+}
+
+
+/**
+ * Get the number of rows (ticks) written to the data file
+ *
+ * @param *ctx The compilation context
+ * @return Number of rows written since datfile_open()
+ */
+unsigned int datfile_rows(vf_ctx_t *ctx) {
+    return ctx->dat.rows;
+}
+
+
+/**
+ * Generate the scheduled event table file
+ *
+ * @param *ctx The compilation context
+ * @param *of File pointer to output file
+ * @param *xf File pointer to the sparse expect file or NULL
+ * @return none
+ */
+void generate_schedule_file(vf_ctx_t *ctx, FILE *of, FILE *xf) {
+    if (datfile_open(ctx, of, xf)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_DATFILE,
+             "unable to allocate data file row buffers");
+        vf_error(ctx);
+    }
+
+    // All rows are known so the file can be sized up front.
+    // If that fails the rows are written through the FILE.
+    if (ctx->dat_format != DAT_FMT_RLE && ctx->dat_format != DAT_FMT_CHG &&
+        _datfile_map(ctx)) {
+        DIAG(&(ctx->diag), DIAG_DEBUG, DIAG_CAT_DATFILE,
+             "unable to map data file, using buffered writes");
+    }
+    datfile_close(ctx);
+}
+
+
+/**
+ * Write a 32 bit unsigned integer, most significant byte
+ * first
+ *
+ * @param *of The file to write to
+ * @param v The value to write
+ * @return none
+ */
+static void _write_u32(FILE *of, unsigned int v) {
+    unsigned char b[4];
+    _put_u32(b, v);
+    fwrite(b, 1, sizeof(b), of);
+}
+
+
+/**
+ * Store a 32 bit unsigned integer, most significant byte
+ * first
+ *
+ * @param *b The 4 bytes to write to
+ * @param v The value to write
+ * @return none
+ */
+static void _put_u32(unsigned char *b, unsigned int v) {
+    b[0] = (v >> 24) & 0xff;
+    b[1] = (v >> 16) & 0xff;
+    b[2] = (v >> 8) & 0xff;
+    b[3] = v & 0xff;
+}
+
+
+/**
+ * Get the width of the outputs (and of the mask) in a row
+ *
+ * @param *ctx The compilation context (after datfile_open())
+ * @return 0 if the expects are in their own file, the
+ *         total width of the outputs otherwise
+ */
+static int _row_outputs(vf_ctx_t *ctx) {
+    return ctx->dat.xf ? 0 : ctx->output_offset;
+}
+
+
+/**
+ * Get the size of one row of a fixed width format
+ *
+ * @param *ctx The compilation context
+ * @return Bytes per row
+ */
+static size_t _row_size(vf_ctx_t *ctx) {
+
+    int outputs = _row_outputs(ctx);
+    size_t width = (outputs * 2) + ctx->input_offset;
+
+    switch (ctx->dat_format) {
+    case DAT_FMT_HEX:
+        return ((width + 3) / 4) + 1;
+    case DAT_FMT_RAW:
+        return (width + 7) / 8;
+    case DAT_FMT_BIN:
+    default:
+        // mask_out_in\n or in\n
+        return width + (outputs ? 3 : 1);
+    }
+}
+
+
+/**
+ * Size the data file for all scheduled rows and map it so
+ * that datfile_emit() can convert rows directly into the
+ * file
+ *
+ * @param *ctx The compilation context (after datfile_open())
+ * @return 0 on success
+ *         1 if the file could not be mapped (it is left as
+ *           it was, for buffered writes)
+ */
+static int _datfile_map(vf_ctx_t *ctx) {
+
+    datfile_t *d = &(ctx->dat);
+    size_t rows;
+    long start;
+    void *map;
+    int fd;
+
+    if (schedule_is_empty(ctx->schedule)) {
+        return 1;
+    }
+
+    // The header (if any) has already been written
+    if (fflush(d->of) || (start = ftell(d->of)) < 0) {
+        return 1;
+    }
+
+    rows = schedule_last_tick(ctx->schedule) - schedule_first_tick(ctx->schedule) + 1;
+    d->map_size = start + (rows * _row_size(ctx));
+    d->map_pos = start;
+
+    fd = fileno(d->of);
+    if (ftruncate(fd, d->map_size)) {
+        return 1;
+    }
+    map = mmap(NULL, d->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        // Buffered writes would leave the sized file padded
+        if (ftruncate(fd, start)) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_DATFILE,
+                 "unable to restore the size of the data file");
+            vf_error(ctx);
+        }
+        return 1;
+    }
+    madvise(map, d->map_size, MADV_SEQUENTIAL);
+    d->map = map;
+    return 0;
+}
+
+
+/**
+ * Add a row to the current run of identical rows. A
+ * different row writes out the current run and starts
+ * a new one.
+ *
+ * @param *d The data file
+ * @param *end One past the last character of the row text
+ * @return none
+ */
+static void _rle_row(datfile_t *d, char *end) {
+
+    size_t len = end - d->row_text;
+    char *t;
+
+    if (d->run && len == d->run_len && !memcmp(d->row_text, d->run_text, len)) {
+        ++d->run;
+        return;
+    }
+
+    _rle_flush(d);
+
+    // The row becomes the start of the next run
+    t = d->run_text;
+    d->run_text = d->row_text;
+    d->row_text = t;
+    d->run_len = len;
+    d->run = 1;
+}
+
+
+/**
+ * Write out the current run as one row prefixed with
+ * its repeat count
+ *
+ * @param *d The data file
+ * @return none
+ */
+static void _rle_flush(datfile_t *d) {
+    if (d->run) {
+        fprintf(d->of, "%u ", d->run);
+        fwrite(d->run_text, sizeof(*(d->run_text)), d->run_len, d->of);
+        d->run = 0;
+    }
+}
+
+
+/**
+ * Write the change list record of a tick: a header with
+ * the number of idle ticks before it, the number of
+ * changed inputs and the number of expects, then one
+ * '<signal> <value>' line for each of them. Inputs are
+ * numbered first, followed by the outputs.
+ *
+ * @param *ctx The compilation context
+ * @param *e The event of the tick (inputs not yet applied)
+ * @return 1 if a record was written
+ *         0 if the tick is idle
+ */
+static int _chg_record(vf_ctx_t *ctx, event_t *e) {
+
+    datfile_t *d = &(ctx->dat);
+    unsigned int k, nsets = 0;
+    symbol_t *s;
+    assign_t *a;
+
+    // Sets that repeat the current value are dropped
+    for (k = 0; k < e->sets.count; ++k) {
+        a = &(e->sets.a[k]);
+        s = ctx->input_syms.syms[a->sym];
+        nsets += !bitvec_equal_words(d->input_bv, s->offset, e->vals + a->slot, s->width);
+    }
+    if (!nsets && !e->xpcts.count) {
+        return 0;
+    }
+
+    fprintf(d->of, "%u %u %u\n", d->idle, nsets, e->xpcts.count);
+    d->idle = 0;
+
+    for (k = 0; k < e->sets.count; ++k) {
+        a = &(e->sets.a[k]);
+        s = ctx->input_syms.syms[a->sym];
+        if (!bitvec_equal_words(d->input_bv, s->offset, e->vals + a->slot, s->width)) {
+            _chg_value(d, a->sym, e->vals + a->slot, s->width);
+        }
+    }
+    for (k = 0; k < e->xpcts.count; ++k) {
+        a = &(e->xpcts.a[k]);
+        s = ctx->output_syms.syms[a->sym];
+        _chg_value(d, ctx->input_syms.count + a->sym, e->vals + a->slot, s->width);
+    }
+    return 1;
+}
+
+
+/**
+ * Write one '<signal> <value>' line of a change list
+ *
+ * @param *d The data file
+ * @param index The signal number
+ * @param *w Packed value, LSB first
+ * @param width Width of the signal
+ * @return none
+ */
+static void _chg_value(datfile_t *d, unsigned int index, uint64_t *w, int width) {
+
+    bitvec_t v;
+    char *p;
+
+    v.width = width;
+    v.nwords = BITVEC_WORDS(width);
+    v.w = w;
+
+    fprintf(d->of, "%u ", index);
+    p = bitvec_to_bin(&v, d->row_text);
+    *p++ = '\n';
+    fwrite(d->row_text, sizeof(*(d->row_text)), p - d->row_text, d->of);
+}
+
+
+/**
+ * Write the expects of the current row to the sparse
+ * expect file as '<tick> mask_out'
+ *
+ * @param *ctx The compilation context
+ * @return none
+ */
+static void _xpct_record(vf_ctx_t *ctx) {
+
+    datfile_t *d = &(ctx->dat);
+    char *p;
+
+    fprintf(d->xf, "%u ", d->rows);
+    p = bitvec_to_bin(d->output_mask, d->row_text);
+    *p++ = '_';
+    p = bitvec_to_bin(d->output_bv, p);
+    *p++ = '\n';
+    fwrite(d->row_text, sizeof(*(d->row_text)), p - d->row_text, d->xf);
+}
@@ -0,0 +1,59 @@
+/**
+ * VeriFrog data file generation header
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_DATFILE_H
+#define VERIFROG_DATFILE_H
+
+#include <stdio.h>
+
+// Raw (DAT_FMT_RAW) file header. All fields are 32 bit
+// unsigned integers, most significant byte first.
+#define DATFILE_RAW_MAGIC "VFRD"
+#define DATFILE_RAW_HEADER_SIZE 16
+#define DATFILE_RAW_ROWS_POS 12
+
+// Output file and row buffers. These persist between
+// calls to datfile_emit() so that rows can be written
+// while the input is still being parsed.
+typedef struct datfile_t {
+	FILE *of;                       // NULL until datfile_open()
+	FILE *xf;                       // Sparse expect file or NULL
+	struct bitvec_t *input_bv;
+	struct bitvec_t *output_bv;
+	struct bitvec_t *output_mask;
+	struct bitvec_t *row_bv;        // Whole row (mask, outputs, inputs)
+	char *row_text;
+	unsigned int rows;              // Rows (ticks) written so far
+
+	// Run length encoding. The last row is held back
+	// until a different row ends its run
+	char *run_text;
+	size_t run_len;
+	unsigned int run;               // Ticks in the held back run
+
+	// Change lists. Ticks without changes or expects are
+	// only counted and skipped by the next record
+	unsigned int idle;
+
+	// Memory mapped output. When map is set rows are
+	// converted straight into the mapping instead of
+	// going through the FILE
+	char *map;
+	size_t map_size;
+	size_t map_pos;                 // Next byte to write
+} datfile_t;
+
+struct vf_ctx_t;
+
+int datfile_open(struct vf_ctx_t *ctx, FILE *of, FILE *xf);
+int datfile_is_open(struct vf_ctx_t *ctx);
+void datfile_emit(struct vf_ctx_t *ctx, int tick);
+void datfile_close(struct vf_ctx_t *ctx);
+unsigned int datfile_rows(struct vf_ctx_t *ctx);
+void generate_schedule_file(struct vf_ctx_t *ctx, FILE *of, FILE *xf);
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * VeriFrog diagnostics
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "diag.h"
+
+#define DIAG_LINE_SIZE 1024
+
+diag_level_t diag_level = DIAG_WARN;
+unsigned int diag_cats = DIAG_CAT_ALL;
+
+static const char *level_names[] = {
+    "ERROR", "WARN", "INFO", "DEBUG", "TRACE"
+};
+
+static const struct {
+    const char *name;
+    unsigned int cat;
+} cat_names[] = {
+    {"main",    DIAG_CAT_MAIN},
+    {"lex",     DIAG_CAT_LEX},
+    {"parse",   DIAG_CAT_PARSE},
+    {"sched",   DIAG_CAT_SCHED},
+    {"dat",     DIAG_CAT_DATFILE},
+    {"tb",      DIAG_CAT_TBFILE},
+    {"batch",   DIAG_CAT_BATCH},
+    {"all",     DIAG_CAT_ALL},
+    {NULL,      0}
+};
+
+
+/**
+ * Format a message and add it to a diagnostics buffer. Use
+ * the DIAG() macro instead so that disabled messages cost
+ * nothing.
+ *
+ * @param *d The buffer or NULL to write to stderr directly
+ * @param lvl The level of the message
+ * @param cat The category (DIAG_CAT_*) of the message
+ * @param *fmt printf style format of the message
+ * @return none
+ */
+void diag_printf(diag_t *d, diag_level_t lvl, unsigned int cat, const char *fmt, ...) {
+
+    char line[DIAG_LINE_SIZE];
+    va_list args;
+    int i, n;
+
+    // Errors and warnings keep the prefix they always had,
+    // the chattier levels also name their category
+    if (lvl >= DIAG_DEBUG) {
+        for (i = 0; cat_names[i].name && cat_names[i].cat != cat; ++i);
+        n = snprintf(line, sizeof(line), "%s [%s]: ", level_names[lvl],
+                     cat_names[i].name ? cat_names[i].name : "?");
+    } else {
+        n = snprintf(line, sizeof(line), "%s: ", level_names[lvl]);
+    }
+
+    va_start(args, fmt);
+    n += vsnprintf(line + n, sizeof(line) - n, fmt, args);
+    va_end(args);
+
+    // Truncate overly long messages
+    if (n > (int)sizeof(line) - 2) {
+        n = sizeof(line) - 2;
+    }
+    line[n++] = '\n';
+    line[n] = '\0';
+
+    if (!d) {
+        fwrite(line, 1, n, stderr);
+        return;
+    }
+    if (d->len + n > sizeof(d->buf)) {
+        diag_flush(d);
+    }
+    memcpy(d->buf + d->len, line, n);
+    d->len += n;
+}
+
+
+/**
+ * Write out all buffered messages
+ *
+ * @param *d The buffer to flush
+ * @return none
+ */
+void diag_flush(diag_t *d) {
+    if (d->len) {
+        fwrite(d->buf, 1, d->len, stderr);
+        fflush(stderr);
+        d->len = 0;
+    }
+}
+
+
+/**
+ * Parse a comma separated list of category names
+ *
+ * @param *s The list, e.g. "parse,sched"
+ * @param *cats Set to the DIAG_CAT_* mask of the list
+ * @return 0 on success
+ *         1 if a name is unknown
+ */
+int diag_parse_cats(const char *s, unsigned int *cats) {
+
+    const char *e;
+    size_t len;
+    int i;
+
+    *cats = 0;
+    while (*s) {
+        e = strchr(s, ',');
+        len = e ? (size_t)(e - s) : strlen(s);
+
+        for (i = 0; cat_names[i].name; ++i) {
+            if (strlen(cat_names[i].name) == len &&
+                !strncmp(cat_names[i].name, s, len)) {
+                break;
+            }
+        }
+        if (!cat_names[i].name) {
+            return 1;
+        }
+        *cats |= cat_names[i].cat;
+
+        s += len;
+        if (*s == ',') {
+            ++s;
+        }
+    }
+    return 0;
+}
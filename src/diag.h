@@ -0,0 +1,72 @@
+/**
+ * VeriFrog diagnostics header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_DIAG_H
+#define VERIFROG_DIAG_H
+
+#include <stddef.h>
+
+typedef enum diag_level_t {
+    DIAG_ERROR,
+    DIAG_WARN,
+    DIAG_INFO,
+    DIAG_DEBUG,
+    DIAG_TRACE
+} diag_level_t;
+
+// Categories of INFO and more verbose messages. Errors and
+// warnings are shown regardless of category.
+#define DIAG_CAT_MAIN    0x01
+#define DIAG_CAT_LEX     0x02
+#define DIAG_CAT_PARSE   0x04
+#define DIAG_CAT_SCHED   0x08
+#define DIAG_CAT_DATFILE 0x10
+#define DIAG_CAT_TBFILE  0x20
+#define DIAG_CAT_BATCH   0x40
+#define DIAG_CAT_ALL     0x7f
+
+// Messages above this level are removed at compile time
+// (e.g. make DIAG_MAX_LEVEL=DIAG_WARN for a release build).
+// Errors and warnings can not be removed.
+#ifndef DIAG_MAX_LEVEL
+#define DIAG_MAX_LEVEL DIAG_TRACE
+#endif
+
+#define DIAG_BUF_SIZE 16384
+
+// Messages of one compilation are collected here and written
+// to stderr together so that the messages of compilations
+// running at the same time do not interleave
+typedef struct diag_t {
+	char buf[DIAG_BUF_SIZE];
+	size_t len;
+} diag_t;
+
+// Set from the command line before any compilation starts
+extern diag_level_t diag_level;
+extern unsigned int diag_cats;
+
+/*
+ * Report a message. d may be NULL to write it out directly.
+ * The arguments are not evaluated if the message is not
+ * shown. The message must not end with a newline.
+ */
+#define DIAG(d, lvl, cat, ...)                                          \
+    do {                                                                \
+        if (((lvl) <= DIAG_WARN || (lvl) <= DIAG_MAX_LEVEL) &&          \
+            (lvl) <= diag_level &&                                      \
+            ((lvl) <= DIAG_WARN || ((cat) & diag_cats))) {              \
+            diag_printf((d), (lvl), (cat), __VA_ARGS__);                \
+        }                                                               \
+    } while (0)
+
+void diag_printf(diag_t *d, diag_level_t lvl, unsigned int cat, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+void diag_flush(diag_t *d);
+int diag_parse_cats(const char *s, unsigned int *cats);
+
+#endif
@@ -6,19 +6,175 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "event.h"
 
+static int _assign_list_reserve(assign_list_t *l, unsigned int sym);
+
+
+/**
+ * Allocate an event with empty sets/xpcts lists
+ * 
+ * @param tick The scheduler tick of the event
+ * @return The new event, NULL on allocation failure
+ */
+event_t *event_create(unsigned int tick) {
+    event_t *e = calloc(1, sizeof(*e));
+    if (e) {
+        e->tick = tick;
+    }
+    return e;
+}
+
+
+/**
+ * Clear all assignments of an event so that it can be
+ * reused for another tick. Its buffers are kept.
+ * 
+ * @param *e The event to reset
+ * @param tick The new scheduler tick of the event
+ * @return none
+ */
+void event_reset(event_t *e, unsigned int tick) {
+    e->n = NULL;
+    e->tick = tick;
+    e->sets.count = 0;
+    e->xpcts.count = 0;
+    e->nvals = 0;
+    if (e->sets.seen) {
+        memset(e->sets.seen, 0, sizeof(*(e->sets.seen)) * e->sets.seen_words);
+    }
+    if (e->xpcts.seen) {
+        memset(e->xpcts.seen, 0, sizeof(*(e->xpcts.seen)) * e->xpcts.seen_words);
+    }
+}
+
+
 /**
- * Free the event struct itself. *e will be NULL following
- * the operation. 
- * NOTE: Does not free the sets/xpcts lists of the event.
+ * Add a net assignment to the sets or xpcts list of an
+ * event. The value is copied into the event so val may
+ * be free'd afterwards. The list is kept in the order of
+ * the statements in the source, and if the net already
+ * has a value in the list the one of the statement that
+ * comes first is kept. Loops are expanded after later
+ * statements may have been scheduled, so the result
+ * must not depend on the order of the calls.
+ * 
+ * @param *e The event to add to
+ * @param *l &e->sets or &e->xpcts
+ * @param *s The symbol of the net
+ * @param *val The value of the net (s->width bits)
+ * @param seq Order of the statement in the source
+ * @return 0 on success
+ *         1 if the net was already assigned in the list
+ *         2 on failure (memory allocation fault)
+ */
+int event_assign(event_t *e, assign_list_t *l, symbol_t *s, const bitvec_t *val,
+                 unsigned int seq) {
+    unsigned int n = BITVEC_WORDS(s->width);
+    unsigned int i, k;
+    uint64_t *v;
+    assign_t *a;
+    assign_t t;
+
+    if (_assign_list_reserve(l, s->index)) {
+        return 2;
+    }
+
+    // Duplicate check. A statement that comes first takes
+    // the place and value of the existing assignment.
+    if ((l->seen[s->index / 64] >> (s->index % 64)) & 1) {
+        for (i = 0; l->a[i].sym != s->index; ++i);
+        if (seq < l->a[i].seq) {
+            t = l->a[i];
+            t.seq = seq;
+            memcpy(e->vals + t.slot, val->w, sizeof(*(e->vals)) * n);
+            for (k = i; k && l->a[k - 1].seq > seq; --k) {
+                l->a[k] = l->a[k - 1];
+            }
+            l->a[k] = t;
+        }
+        return 1;
+    }
+    
+    if (e->nvals + n > e->vals_size) {
+        unsigned int size = e->vals_size ? e->vals_size : 4;
+        while (size < e->nvals + n) {
+            size *= 2;
+        }
+        v = realloc(e->vals, sizeof(*v) * size);
+        if (!v) {
+            return 2;
+        }
+        e->vals = v;
+        e->vals_size = size;
+    }
+    
+    // Almost always appended at the end
+    for (k = l->count; k && l->a[k - 1].seq > seq; --k) {
+        l->a[k] = l->a[k - 1];
+    }
+    ++l->count;
+    a = &(l->a[k]);
+    a->sym = s->index;
+    a->slot = e->nvals;
+    a->seq = seq;
+    memcpy(e->vals + e->nvals, val->w, sizeof(*(e->vals)) * n);
+    e->nvals += n;
+    l->seen[s->index / 64] |= (uint64_t)1 << (s->index % 64);
+    return 0;
+}
+
+
+/**
+ * Free the event struct and its assignments. *e will be
+ * NULL following the operation. 
  * 
  * @param **e Pointer to the struct to be free'd
  * @return none
  */
 void event_destroy(event_t **e) {
+    free((*e)->sets.a);
+    free((*e)->sets.seen);
+    free((*e)->xpcts.a);
+    free((*e)->xpcts.seen);
+    free((*e)->vals);
     free (*e);
     *e = NULL;
 }
 
+
+/**
+ * Make room in a list for one more assignment and make
+ * sure the seen bitset covers a symbol index
+ * 
+ * @param *l The list to grow
+ * @param sym The symbol index that will be added
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+static int _assign_list_reserve(assign_list_t *l, unsigned int sym) {
+    unsigned int words = (sym / 64) + 1;
+    
+    if (l->count == l->size) {
+        unsigned int size = l->size ? l->size * 2 : 4;
+        assign_t *a = realloc(l->a, sizeof(*a) * size);
+        if (!a) {
+            return 1;
+        }
+        l->a = a;
+        l->size = size;
+    }
+
+    if (words > l->seen_words) {
+        uint64_t *seen = realloc(l->seen, sizeof(*seen) * words);
+        if (!seen) {
+            return 1;
+        }
+        memset(seen + l->seen_words, 0, sizeof(*seen) * (words - l->seen_words));
+        l->seen = seen;
+        l->seen_words = words;
+    }
+    return 0;
+}
@@ -8,15 +8,42 @@
 #ifndef VERIFROG_EVENT_H
 #define VERIFROG_EVENT_H
 
+#include <stdint.h>
+
+#include "bitvec.h"
+#include "symbol.h"
+
+// A net resolved to its index in the input or output
+// symbol list and the location of its value in the
+// value words of the event
+typedef struct assign_t {
+	unsigned int sym;   // Symbol index
+	unsigned int slot;  // Index in vals of the first value word
+	unsigned int seq;   // Order of the statement in the source
+} assign_t;
+
+typedef struct assign_list_t {
+	assign_t *a;                // Assignments in source order
+	unsigned int count;
+	unsigned int size;
+	uint64_t *seen;             // Bitset of the symbol indices in a
+	unsigned int seen_words;
+} assign_list_t;
+
 typedef struct event_t {
-	struct event_t *n;
-	struct event_t *p;
+	struct event_t *n;          // Next free event while pooled
 	unsigned int tick;
-	struct varval_t *sets;
-	struct varval_t *xpcts;
+	assign_list_t sets;
+	assign_list_t xpcts;
+	uint64_t *vals;             // Packed values of all assignments
+	unsigned int nvals;
+	unsigned int vals_size;
 } event_t;
 
+event_t *event_create(unsigned int tick);
+void event_reset(event_t *e, unsigned int tick);
+int event_assign(event_t *e, assign_list_t *l, symbol_t *s, const bitvec_t *val,
+                 unsigned int seq);
 void event_destroy(event_t **e);
 
 #endif
-
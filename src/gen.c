@@ -0,0 +1,718 @@
+/**
+ * VeriFrog stimulus generators
+ *
+ * Repeat blocks and for loops are stored once as a list of
+ * statements and are only expanded into the schedule when
+ * the rows of their ticks are about to be written. A long
+ * loop then costs memory in proportion to its body rather
+ * than to the number of ticks it covers. Values that use
+ * a loop variable are computed on each pass.
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "arena.h"
+#include "bitvec.h"
+#include "verifrog.h"
+#include "event.h"
+#include "schedule.h"
+#include "gen.h"
+
+#define GEN_INITIAL_DEPTH 4
+
+static varval_t *_copy_varvals(vf_ctx_t *ctx, varval_t *vvl);
+static void _insert_varvals(vf_ctx_t *ctx, event_t *e, assign_list_t *l,
+                            varval_t *vvl, unsigned int line, unsigned int seq);
+static int _push(gen_t *g, gen_block_t *b, unsigned int count);
+static void _step(vf_ctx_t *ctx, gen_t *g);
+static void _eval_varvals(vf_ctx_t *ctx, gen_stmt_t *s);
+static uint64_t _eval(vf_ctx_t *ctx, gen_expr_t *e, unsigned int line);
+static int _apply(gen_expr_op_t op, uint64_t a, uint64_t b, uint64_t *val);
+static gen_expr_t *_expr_alloc(vf_ctx_t *ctx, gen_expr_op_t op);
+
+
+/**
+ * Start a repeat block or for loop. Statements are added
+ * to it until the matching gen_end().
+ *
+ * @param *ctx The compilation context
+ * @param *var Name of the loop variable, NULL for a repeat
+ * @return none
+ */
+void gen_begin(vf_ctx_t *ctx, char *var) {
+
+    gen_block_t *b = arena_alloc(ctx->session_arena, sizeof(*b));
+    if (!b) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "could not allocate repeat block on line %d", ctx->linenum);
+        vf_error(ctx);
+    }
+    b->first = NULL;
+    b->last = NULL;
+    b->ticks = 0;
+    b->reach = GEN_NO_REACH;
+    b->parent = ctx->gen_open;
+    b->var = var;
+    b->value = 0;
+    b->from = 0;
+    b->step = 0;
+    ctx->gen_open = b;
+}
+
+
+/**
+ * Add a set or expect statement to the innermost open
+ * repeat block. The var-val list is copied out of the
+ * scratch arena.
+ *
+ * @param *ctx The compilation context
+ * @param op GEN_SET or GEN_EXPECT
+ * @param *vvl The values of the statement
+ * @param delay GEN_EXPECT: ticks after the current tick
+ * @return none
+ */
+void gen_add(vf_ctx_t *ctx, gen_op_t op, varval_t *vvl, int delay) {
+
+    gen_block_t *b = ctx->gen_open;
+    gen_stmt_t *s = arena_alloc(ctx->session_arena, sizeof(*s));
+    if (!s) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "could not allocate repeat statement on line %d", ctx->linenum);
+        vf_error(ctx);
+    }
+    s->op = op;
+    s->line = ctx->linenum;
+    s->delay = delay;
+    s->vvl = _copy_varvals(ctx, vvl);
+    s->count = 0;
+    s->body = NULL;
+    s->n = NULL;
+
+    // Ticks are counted relative to the start of a pass
+    if (op == GEN_SET) {
+        ++b->ticks;
+        if (b->ticks > b->reach) {
+            b->reach = b->ticks;
+        }
+    } else if (b->ticks + delay > b->reach) {
+        b->reach = b->ticks + delay;
+    }
+
+    if (b->last) {
+        b->last->n = s;
+    } else {
+        b->first = s;
+    }
+    b->last = s;
+    arena_reset(ctx->scratch_arena);
+}
+
+
+/**
+ * Close the innermost repeat block or for loop. A nested
+ * block becomes a statement of its parent. An outermost
+ * block becomes a generator starting at the current tick,
+ * which then moves past all ticks it covers.
+ *
+ * @param *ctx The compilation context
+ * @param count The number of passes over the block
+ * @param from For loops: value of the variable on the first pass
+ * @param step For loops: change of the variable after each pass
+ * @return none
+ */
+void gen_end(vf_ctx_t *ctx, unsigned int count, long long from, long long step) {
+
+    gen_block_t *b = ctx->gen_open;
+    gen_block_t *p = b->parent;
+    long long ticks, reach = GEN_NO_REACH;
+    gen_stmt_t *s;
+    gen_t *g, **gp;
+
+    ctx->gen_open = p;
+    b->from = from;
+    b->step = step;
+
+    // Ticks covered by all passes
+    ticks = (long long)b->ticks * count;
+    if (count && b->reach != GEN_NO_REACH) {
+        reach = ((long long)b->ticks * (count - 1)) + b->reach;
+    }
+    if ((p ? p->ticks : ctx->current_tick) + ticks > INT_MAX ||
+        (p ? p->ticks : ctx->current_tick) + reach > INT_MAX) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "repeat block covers too many ticks on line %d", ctx->linenum);
+        vf_error(ctx);
+    }
+
+    if (p) {
+        s = arena_alloc(ctx->session_arena, sizeof(*s));
+        if (!s) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "could not allocate repeat statement on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        s->op = GEN_REPEAT;
+        s->line = ctx->linenum;
+        s->delay = 0;
+        s->vvl = NULL;
+        s->count = count;
+        s->body = b;
+        s->n = NULL;
+
+        if (reach != GEN_NO_REACH && p->ticks + reach > p->reach) {
+            p->reach = p->ticks + reach;
+        }
+        p->ticks += ticks;
+
+        if (p->last) {
+            p->last->n = s;
+        } else {
+            p->first = s;
+        }
+        p->last = s;
+        return;
+    }
+
+    if (!count || !b->first) {
+        return;
+    }
+
+    g = calloc(1, sizeof(*g));
+    if (!g || _push(g, b, count)) {
+        free(g);
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "could not allocate repeat generator on line %d", ctx->linenum);
+        vf_error(ctx);
+    }
+    g->cur = ctx->current_tick;
+
+    // All values of the loop come before those of the
+    // statements after it, whenever it is expanded
+    g->seq = ctx->seq++;
+
+    // Earlier generators are run first
+    for (gp = &(ctx->gens); *gp; gp = &((*gp)->n));
+    *gp = g;
+
+    // The rows up to the last tick of the generator must
+    // be written even though it has no events yet
+    if (reach != GEN_NO_REACH) {
+        schedule_reserve(ctx->schedule, ctx->current_tick + reach);
+    }
+    ctx->current_tick += ticks;
+}
+
+
+/**
+ * Make a constant expression
+ *
+ * @param *ctx The compilation context
+ * @param val The value
+ * @return The expression
+ */
+gen_expr_t *gen_expr_const(vf_ctx_t *ctx, uint64_t val) {
+    gen_expr_t *e = _expr_alloc(ctx, GEN_EXPR_CONST);
+    e->val = val;
+    return e;
+}
+
+
+/**
+ * Make an expression of a sized constant. It keeps its
+ * width when it is assigned as is.
+ *
+ * @param *ctx The compilation context
+ * @param *vec The constant
+ * @return The expression
+ */
+gen_expr_t *gen_expr_vec(vf_ctx_t *ctx, bitvec_t *vec) {
+    gen_expr_t *e = _expr_alloc(ctx, GEN_EXPR_VEC);
+    e->vec = vec;
+    return e;
+}
+
+
+/**
+ * Make an expression of the innermost loop variable with
+ * the given name
+ *
+ * @param *ctx The compilation context
+ * @param *name The name of the variable
+ * @return The expression
+ */
+gen_expr_t *gen_expr_var(vf_ctx_t *ctx, const char *name) {
+
+    gen_block_t *b;
+    gen_expr_t *e;
+
+    for (b = ctx->gen_open; b && !(b->var && !strcmp(b->var, name)); b = b->parent);
+    if (!b) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "Unknown loop variable '%s' on line %d", name, ctx->linenum);
+        vf_error(ctx);
+    }
+    e = _expr_alloc(ctx, GEN_EXPR_VAR);
+    e->loop = b;
+    return e;
+}
+
+
+/**
+ * Make an operator expression. Operators on constants are
+ * evaluated right away.
+ *
+ * @param *ctx The compilation context
+ * @param op The operator
+ * @param *l The (left) operand
+ * @param *r The right operand, NULL for unary operators
+ * @return The expression
+ */
+gen_expr_t *gen_expr(vf_ctx_t *ctx, gen_expr_op_t op, gen_expr_t *l, gen_expr_t *r) {
+
+    gen_expr_t *o[2];
+    gen_expr_t *e;
+    int i;
+
+    // Sized constants are used as plain numbers
+    o[0] = l;
+    o[1] = r;
+    for (i = 0; i < 2; ++i) {
+        if (o[i] && o[i]->op == GEN_EXPR_VEC) {
+            if (o[i]->vec->width > BITVEC_WORD_BITS) {
+                DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                     "constant wider than %d bits in an expression on line %d",
+                     BITVEC_WORD_BITS, ctx->linenum);
+                vf_error(ctx);
+            }
+            o[i] = gen_expr_const(ctx, o[i]->vec->nwords ? o[i]->vec->w[0] : 0);
+        }
+    }
+
+    if (o[0]->op == GEN_EXPR_CONST && (!o[1] || o[1]->op == GEN_EXPR_CONST)) {
+        e = gen_expr_const(ctx, 0);
+        if (_apply(op, o[0]->val, o[1] ? o[1]->val : 0, &(e->val))) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "division by zero on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        return e;
+    }
+
+    e = _expr_alloc(ctx, op);
+    e->l = o[0];
+    e->r = o[1];
+    return e;
+}
+
+
+/**
+ * Set the value of a var-val pair from an expression. A
+ * sized constant must have the width of the net, other
+ * values are truncated to it. Values that depend on a
+ * loop variable are left to the generator.
+ *
+ * @param *ctx The compilation context
+ * @param *vv The var-val pair (sym set)
+ * @param *e The value
+ * @return none
+ */
+void gen_varval(vf_ctx_t *ctx, varval_t *vv, gen_expr_t *e) {
+
+    vv->expr = NULL;
+    if (e->op == GEN_EXPR_VEC) {
+        if (vv->sym->width != e->vec->width) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "Mismatched vector width (%d != %d) on line %d",
+                 e->vec->width, vv->sym->width, ctx->linenum);
+            vf_error(ctx);
+        }
+        vv->val = e->vec;
+        return;
+    }
+
+    vv->val = bitvec_alloc(ctx->scratch_arena, vv->sym->width);
+    if (!vv->val) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "could not allocate var-val pair on line %d", ctx->linenum);
+        vf_error(ctx);
+    }
+    if (e->op == GEN_EXPR_CONST) {
+        bitvec_insert_words(vv->val, 0, &(e->val),
+                            vv->sym->width < BITVEC_WORD_BITS ? vv->sym->width : BITVEC_WORD_BITS);
+    } else {
+        vv->expr = e;
+    }
+}
+
+
+/**
+ * Expand all generators up to (and including) the first
+ * set after the given tick. Everything they schedule
+ * later is after the tick, so its row is then complete.
+ *
+ * @param *ctx The compilation context
+ * @param tick The tick whose row is to be written
+ * @return none
+ */
+void gen_run(vf_ctx_t *ctx, int tick) {
+
+    gen_t **gp = &(ctx->gens);
+    gen_t *g;
+
+    while ((g = *gp)) {
+        while (g->depth && g->cur <= tick) {
+            _step(ctx, g);
+        }
+
+        // Drop finished generators
+        if (!g->depth) {
+            *gp = g->n;
+            free(g->stack);
+            free(g);
+        } else {
+            gp = &(g->n);
+        }
+    }
+}
+
+
+/**
+ * Enter the values of a set or expect into the event of
+ * a tick
+ *
+ * @param *ctx The compilation context
+ * @param *vvl var-val pair list to add
+ * @param tick The scheduler tick of the event to modify
+ * @param sched_set 1 = SETs
+ *                  0 = EXPECTs
+ * @param line The source line of the values
+ * @param seq Order of the statement, or of its loop, in
+ *            the source
+ * @return none
+ */
+void gen_schedule(vf_ctx_t *ctx, varval_t *vvl, int tick, int sched_set,
+                  unsigned int line, unsigned int seq) {
+
+    event_t *e;
+
+    if (tick < 0) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "cannot schedule event before the first tick on line %d", line);
+        vf_error(ctx);
+    }
+
+    STATS_ENTER(&(ctx->stats), STATS_SCHED);
+    e = schedule_get(ctx->schedule, tick);
+
+    // If an event for this tick does not exist, create a new event
+    if (!e) {
+        DIAG(&(ctx->diag), DIAG_TRACE, DIAG_CAT_SCHED, "creating new tick %d", tick);
+        e = schedule_insert(ctx->schedule, tick);
+        if (!e) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "failed allocating event (sets)");
+            vf_error(ctx);
+        }
+        ++ctx->stats.events;
+    } else {
+        DIAG(&(ctx->diag), DIAG_TRACE, DIAG_CAT_SCHED,
+             "updating existing tick %d", tick);
+    }
+
+    // Insert each set into the sets list of the event
+    if (sched_set) {
+        _insert_varvals(ctx, e, &(e->sets), vvl, line, seq);
+    } else {
+        _insert_varvals(ctx, e, &(e->xpcts), vvl, line, seq);
+    }
+    STATS_LEAVE(&(ctx->stats));
+}
+
+
+/**
+ * Free all generators that have not finished
+ *
+ * @param *ctx The compilation context
+ * @return none
+ */
+void gen_free(vf_ctx_t *ctx) {
+    gen_t *g;
+    while ((g = ctx->gens)) {
+        ctx->gens = g->n;
+        free(g->stack);
+        free(g);
+    }
+    ctx->gen_open = NULL;
+}
+
+
+/**
+ * Copy a var-val list and its values into the session
+ * arena
+ *
+ * @param *ctx The compilation context
+ * @param *vvl The list to copy
+ * @return The copy (in the same order)
+ */
+static varval_t *_copy_varvals(vf_ctx_t *ctx, varval_t *vvl) {
+
+    varval_t *head = NULL;
+    varval_t **tail = &head;
+    varval_t *c;
+
+    for (; vvl; vvl = vvl->n) {
+        c = arena_alloc(ctx->session_arena, sizeof(*c));
+        if (c) {
+            c->val = bitvec_alloc(ctx->session_arena, vvl->val->width);
+        }
+        if (!c || !c->val) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "could not allocate var-val pair on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        memcpy(c->val->w, vvl->val->w, sizeof(*(c->val->w)) * c->val->nwords);
+        c->sym = vvl->sym;
+        c->expr = vvl->expr;
+        c->n = NULL;
+        *tail = c;
+        tail = &(c->n);
+    }
+    return head;
+}
+
+
+/**
+ * Copy all assignments of a var-val list into the sets
+ * or xpcts of an event
+ *
+ * @param *ctx The compilation context
+ * @param *e The event to which the assignments should be added
+ * @param *l &e->sets or &e->xpcts
+ * @param *vvl The var-val list
+ * @param line The source line of the values
+ * @param seq Order of the statement in the source
+ * @return none
+ */
+static void _insert_varvals(vf_ctx_t *ctx, event_t *e, assign_list_t *l,
+                            varval_t *vvl, unsigned int line, unsigned int seq) {
+    varval_t *i;
+    for (i = vvl; i; i = i->n) {
+        DIAG(&(ctx->diag), DIAG_TRACE, DIAG_CAT_SCHED, "SS: %s", i->sym->sym);
+        ++ctx->stats.varvals;
+        switch (event_assign(e, l, i->sym, i->val, seq)) {
+        case 0:
+            break;
+        case 1:
+            DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_PARSE,
+                 "Multiple values for '%s' at time %d on line %d",
+                 i->sym->sym, e->tick, line);
+            break;
+        default:
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "failed allocating event assignment");
+            vf_error(ctx);
+        }
+    }
+}
+
+
+/**
+ * Start the passes over a block
+ *
+ * @param *g The generator
+ * @param *b The block
+ * @param count The number of passes
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+static int _push(gen_t *g, gen_block_t *b, unsigned int count) {
+
+    gen_frame_t *stack;
+
+    if (g->depth == g->size) {
+        stack = realloc(g->stack, sizeof(*stack) *
+                        (g->size ? g->size * 2 : GEN_INITIAL_DEPTH));
+        if (!stack) {
+            return 1;
+        }
+        g->stack = stack;
+        g->size = g->size ? g->size * 2 : GEN_INITIAL_DEPTH;
+    }
+    g->stack[g->depth].b = b;
+    g->stack[g->depth].s = b->first;
+    g->stack[g->depth].left = count;
+    ++g->depth;
+    b->value = b->from;
+    return 0;
+}
+
+
+/**
+ * Run the next statement of a generator
+ *
+ * @param *ctx The compilation context
+ * @param *g The generator
+ * @return none
+ */
+static void _step(vf_ctx_t *ctx, gen_t *g) {
+
+    gen_frame_t *f = &(g->stack[g->depth - 1]);
+    gen_stmt_t *s = f->s;
+
+    // End of a pass, start the next one or leave the block
+    if (!s) {
+        if (--f->left) {
+            f->s = f->b->first;
+            f->b->value += f->b->step;
+        } else {
+            --g->depth;
+        }
+        return;
+    }
+    f->s = s->n;
+
+    switch (s->op) {
+    case GEN_SET:
+        ++g->cur;
+        _eval_varvals(ctx, s);
+        gen_schedule(ctx, s->vvl, g->cur, 1, s->line, g->seq);
+        break;
+
+    case GEN_EXPECT:
+        _eval_varvals(ctx, s);
+        gen_schedule(ctx, s->vvl, g->cur + s->delay, 0, s->line, g->seq);
+        break;
+
+    case GEN_REPEAT:
+        if (s->count && s->body->first && _push(g, s->body, s->count)) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_SCHED,
+                 "could not allocate repeat generator");
+            vf_error(ctx);
+        }
+        break;
+    }
+}
+
+
+/**
+ * Compute the values of a statement that depend on loop
+ * variables
+ *
+ * @param *ctx The compilation context
+ * @param *s The set or expect statement
+ * @return none
+ */
+static void _eval_varvals(vf_ctx_t *ctx, gen_stmt_t *s) {
+
+    varval_t *i;
+    uint64_t v;
+
+    for (i = s->vvl; i; i = i->n) {
+        if (i->expr) {
+            v = _eval(ctx, i->expr, s->line);
+            bitvec_clear(i->val);
+            bitvec_insert_words(i->val, 0, &v,
+                                i->val->width < BITVEC_WORD_BITS ? i->val->width : BITVEC_WORD_BITS);
+        }
+    }
+}
+
+
+/**
+ * Evaluate an expression with the current values of the
+ * loop variables
+ *
+ * @param *ctx The compilation context
+ * @param *e The expression
+ * @param line The source line for messages
+ * @return The value
+ */
+static uint64_t _eval(vf_ctx_t *ctx, gen_expr_t *e, unsigned int line) {
+
+    uint64_t v;
+
+    switch (e->op) {
+    case GEN_EXPR_CONST:
+        return e->val;
+    case GEN_EXPR_VEC:
+        return e->vec->nwords ? e->vec->w[0] : 0;
+    case GEN_EXPR_VAR:
+        return (uint64_t)e->loop->value;
+    default:
+        break;
+    }
+
+    if (_apply(e->op, _eval(ctx, e->l, line), e->r ? _eval(ctx, e->r, line) : 0, &v)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_SCHED,
+             "division by zero on line %d", line);
+        vf_error(ctx);
+    }
+    return v;
+}
+
+
+/**
+ * Apply an operator
+ *
+ * @param op The operator
+ * @param a The (left) operand
+ * @param b The right operand (unused by unary operators)
+ * @param *val Set to the result
+ * @return 0 on success
+ *         1 on division by zero
+ */
+static int _apply(gen_expr_op_t op, uint64_t a, uint64_t b, uint64_t *val) {
+    switch (op) {
+    case GEN_EXPR_NEG: *val = -a; break;
+    case GEN_EXPR_NOT: *val = ~a; break;
+    case GEN_EXPR_ADD: *val = a + b; break;
+    case GEN_EXPR_SUB: *val = a - b; break;
+    case GEN_EXPR_MUL: *val = a * b; break;
+    case GEN_EXPR_DIV:
+    case GEN_EXPR_MOD:
+        if (!b) {
+            return 1;
+        }
+        *val = (op == GEN_EXPR_DIV) ? a / b : a % b;
+        break;
+    case GEN_EXPR_AND: *val = a & b; break;
+    case GEN_EXPR_OR:  *val = a | b; break;
+    case GEN_EXPR_XOR: *val = a ^ b; break;
+    case GEN_EXPR_SHL: *val = (b < 64) ? a << b : 0; break;
+    case GEN_EXPR_SHR: *val = (b < 64) ? a >> b : 0; break;
+    default:
+        *val = a;
+        break;
+    }
+    return 0;
+}
+
+
+/**
+ * Allocate an expression node. Expressions in a loop are
+ * kept with the loop, others only live until their block
+ * has been scheduled.
+ *
+ * @param *ctx The compilation context
+ * @param op The operator of the node
+ * @return The node with all operands cleared
+ */
+static gen_expr_t *_expr_alloc(vf_ctx_t *ctx, gen_expr_op_t op) {
+
+    gen_expr_t *e = arena_alloc(ctx->gen_open ? ctx->session_arena : ctx->scratch_arena,
+                                sizeof(*e));
+    if (!e) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "could not allocate expression on line %d", ctx->linenum);
+        vf_error(ctx);
+    }
+    memset(e, 0, sizeof(*e));
+    e->op = op;
+    return e;
+}
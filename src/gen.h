@@ -0,0 +1,117 @@
+/**
+ * VeriFrog stimulus generator header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_GEN_H
+#define VERIFROG_GEN_H
+
+#include <stdint.h>
+
+#include "bitvec.h"
+#include "varvalpair.h"
+
+typedef enum gen_op_t {
+    GEN_SET,
+    GEN_EXPECT,
+    GEN_REPEAT                      // Also a for loop
+} gen_op_t;
+
+// One statement of a block. Statements and their values
+// are allocated from the session arena.
+typedef struct gen_stmt_t {
+	gen_op_t op;
+	unsigned int line;              // Source line for messages
+	int delay;                      // GEN_EXPECT: ticks after the current tick
+	varval_t *vvl;                  // GEN_SET, GEN_EXPECT
+	unsigned int count;             // GEN_REPEAT: number of passes
+	struct gen_block_t *body;       // GEN_REPEAT
+	struct gen_stmt_t *n;
+} gen_stmt_t;
+
+// The body of a repeat or for loop. A block cannot drain
+// so the ticks it covers are known without running it.
+typedef struct gen_block_t {
+	gen_stmt_t *first;
+	gen_stmt_t *last;
+	int ticks;                      // Ticks advanced by one pass
+	int reach;                      // Last tick scheduled by one pass, relative
+	                                // to its start (GEN_NO_REACH if none)
+	struct gen_block_t *parent;     // Enclosing block while parsing
+
+	// Loop variable of a for loop (var is NULL for a repeat)
+	char *var;
+	long long value;                // Value during the current pass
+	long long from;
+	long long step;
+} gen_block_t;
+
+typedef enum gen_expr_op_t {
+    GEN_EXPR_CONST,                 // val
+    GEN_EXPR_VEC,                   // vec, a sized constant as written
+    GEN_EXPR_VAR,                   // The loop variable of loop
+    GEN_EXPR_NEG,
+    GEN_EXPR_NOT,
+    GEN_EXPR_ADD,
+    GEN_EXPR_SUB,
+    GEN_EXPR_MUL,
+    GEN_EXPR_DIV,
+    GEN_EXPR_MOD,
+    GEN_EXPR_AND,
+    GEN_EXPR_OR,
+    GEN_EXPR_XOR,
+    GEN_EXPR_SHL,
+    GEN_EXPR_SHR
+} gen_expr_op_t;
+
+// Value of an assignment. Expressions are evaluated with
+// 64 bit unsigned arithmetic and truncated to the width
+// of the net they are assigned to.
+typedef struct gen_expr_t {
+	gen_expr_op_t op;
+	uint64_t val;
+	bitvec_t *vec;
+	gen_block_t *loop;
+	struct gen_expr_t *l;
+	struct gen_expr_t *r;           // NULL for unary operators
+} gen_expr_t;
+
+#define GEN_NO_REACH (-2147483647 - 1)
+
+// Position in one (possibly nested) block of a generator
+typedef struct gen_frame_t {
+	gen_block_t *b;
+	gen_stmt_t *s;                  // Next statement, NULL at the end of a pass
+	unsigned int left;              // Passes left including the current one
+} gen_frame_t;
+
+// A top level repeat or for loop that has not been fully
+// expanded. It is run a tick at a time as its rows are
+// written.
+typedef struct gen_t {
+	gen_frame_t *stack;
+	unsigned int depth;
+	unsigned int size;
+	int cur;                        // Tick of the last expanded set
+	unsigned int seq;               // Order of the loop in the source
+	struct gen_t *n;
+} gen_t;
+
+struct vf_ctx_t;
+
+void gen_begin(struct vf_ctx_t *ctx, char *var);
+void gen_add(struct vf_ctx_t *ctx, gen_op_t op, varval_t *vvl, int delay);
+void gen_end(struct vf_ctx_t *ctx, unsigned int count, long long from, long long step);
+gen_expr_t *gen_expr_const(struct vf_ctx_t *ctx, uint64_t val);
+gen_expr_t *gen_expr_vec(struct vf_ctx_t *ctx, bitvec_t *vec);
+gen_expr_t *gen_expr_var(struct vf_ctx_t *ctx, const char *name);
+gen_expr_t *gen_expr(struct vf_ctx_t *ctx, gen_expr_op_t op, gen_expr_t *l, gen_expr_t *r);
+void gen_varval(struct vf_ctx_t *ctx, varval_t *vv, gen_expr_t *e);
+void gen_run(struct vf_ctx_t *ctx, int tick);
+void gen_schedule(struct vf_ctx_t *ctx, varval_t *vvl, int tick, int sched_set,
+                  unsigned int line, unsigned int seq);
+void gen_free(struct vf_ctx_t *ctx);
+
+#endif
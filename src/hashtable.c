@@ -5,6 +5,10 @@
 
 #include "hashtable.h"
 
+static unsigned int _hashtable_find_slot(hashtable_t *table, const char *key, unsigned long hash);
+static int _hashtable_rebuild(hashtable_t *table, unsigned int arraySize);
+
+
 /**
  * Initialize a hashtable struct
  * 
@@ -15,28 +19,29 @@
 int hashtable_init(hashtable_t **table)
 {
     (*table) = malloc(sizeof(**table));
-    (*table)->arraySize = HASHTABLE_INITIAL_SIZE;
-    (*table)->currentLoadFactor = 0;
-    (*table)->numberOfItemsInTable = 0;
-    (*table)->numberOfSlotsUsed = 0;
-    (*table)->table = malloc(sizeof(*((*table)->table)) * (*table)->arraySize);
-
-    if ((*table)->table == NULL)
+    if ((*table) == NULL)
     {
         return 1;    // Unable to malloc memory
     }
-    
-    for (int i = 0; i < (*table)->arraySize; i++)
+    (*table)->numberOfItemsInTable = 0;
+    (*table)->numberOfEntries = 0;
+    (*table)->entriesSize = HASHTABLE_INITIAL_SIZE / 2;
+    (*table)->arraySize = HASHTABLE_INITIAL_SIZE;
+    (*table)->entries = malloc(sizeof(*((*table)->entries)) * (*table)->entriesSize);
+    (*table)->slots = calloc((*table)->arraySize, sizeof(*((*table)->slots)));
+
+    if ((*table)->entries == NULL || (*table)->slots == NULL)
     {
-        (*table)->table[i] = NULL;//malloc(sizeof(hashtable_entry_t *));
+        hashtable_destroy(table);
+        return 1;    // Unable to malloc memory
     }
     return 0;
 }
 
 
 /**
- * Reset the hashtable to its original size and remove the elements from it<br>
- * Note: <code>free()</code>s all elements in table array!
+ * Remove all elements from the hashtable<br>
+ * Note: Does not <code>free()</code> keys or values
  * 
  * @param table The hashtable to be cleared
  */
@@ -44,97 +49,17 @@ void hashtable_clear(hashtable_t *table)
 {
     if (table != NULL)
     {
-        // Free the elements in the table
-        for (int i = 0; i < table->arraySize; i++)
-        {
-            if (table->table[i])
-            {
-                free(table->table[i]);
-            }
-        }
-        free(table->table);
-
-        // Create new table
-        table->arraySize = HASHTABLE_INITIAL_SIZE;
-        table->table = malloc(sizeof(*(table->table)) * table->arraySize);
-    }
-}
-
-
-/**
- * Add an element to the hashtable
- * Assumes that you have already malloc()'d the value pointer
- * 
- * @param table The HashTable to be operated upon
- * @param key The key associated with the provided value
- * @param value The value to be associated with the key
- */
-void hashtable_put(hashtable_t *table, unsigned long key, void *value)
-{
-    if (table != NULL)
-    {
-        unsigned int pointer = _hashtable_compute_index(table, key);
-
-        hashtable_entry_t *item = malloc(sizeof(*item));
-        
-        item->next = NULL;
-        item->value = value;
-        item->key = key;
-
-        // If this location in the table is empty, just add the node
-        if (table->table[pointer] == NULL)
-        {
-            table->table[pointer] = item;
-            table->numberOfSlotsUsed++;
-        }
-        else
-        {
-            hashtable_entry_t *node = table->table[pointer];
-            int done = 0;
-            while (node != NULL && !done)
-            {
-                if ((item->key) > (node->key) && node->next == NULL)
-                {
-                    node->next = item;
-                    done = 1;
-                }
-                else if (node->next != NULL && (item->key) < (node->next->key) && (item->key) > (node->key))
-                {
-                    item->next = node->next;
-                    node->next = item;
-                    done = 1;
-                }
-                else if (item->key < node->key)
-                {
-                    item->next = node;
-                    table->table[pointer] = item;
-                    done = 1;
-                }
-                else if (item->key == node->key) // Item is the same as the node
-                {
-                    node->value = item->value;
-                    free(item);
-                    table->numberOfItemsInTable--; // Cancel out addition at end of function
-                    done = 1;
-                }
-                node = node->next;
-            }
-        }
-
-        // Update the number of items in the table and current load factor
-        table->numberOfItemsInTable++;
-        table->currentLoadFactor = _hashtable_get_load_factor(table);
-
-        // Expand the table if needed
-        if (table->currentLoadFactor - HASHTABLE_DEFAULT_MAX_POSITIVE_LOAD_FACTOR_VARIANCE > HASHTABLE_DEFAULT_LOAD_FACTOR)
-            _hashtable_double_table(table);
+        table->numberOfItemsInTable = 0;
+        table->numberOfEntries = 0;
+        memset(table->slots, 0, sizeof(*(table->slots)) * table->arraySize);
     }
 }
 
 
 /**
- * Add an element to the hashtable
- * Assumes that you have already malloc()'d the value pointer
+ * Add an element to the hashtable. If the key already
+ * exists its value is replaced.
+ * The key is not copied and must outlive the table.
  * 
  * @param table The HashTable to be operated upon
  * @param key The key associated with the provided value
@@ -144,90 +69,47 @@ void hashtable_sput(hashtable_t *table, char *key, void *value)
 {
     if (table != NULL && key != NULL)
     {
-        unsigned long keyi = hashtable_hash_string(key);
-        unsigned int hashValue = _hashtable_compute_index(table, keyi);
-
-        hashtable_entry_t *item = malloc(sizeof(*item));
+        unsigned long hash = hashtable_hash_string(key);
+        unsigned int slot = _hashtable_find_slot(table, key, hash);
+        hashtable_entry_t *item;
 
-        item->next = NULL;
-        item->value = value;
-        item->key = keyi;
-
-        // If this location in the table is empty, just add the node
-        if (table->table[hashValue] == NULL)
+        // Item is already in the table
+        if (table->slots[slot] != 0)
         {
-            table->table[hashValue] = item;
-            table->numberOfSlotsUsed++;
+            table->entries[table->slots[slot] - 1].value = value;
+            return;
         }
-        else
+
+        // Expand the table if needed (removed entries are
+        // dropped when the table is rebuilt)
+        if ((table->numberOfEntries + 1) > table->arraySize * HASHTABLE_MAX_LOAD_FACTOR)
         {
-            hashtable_entry_t *node = table->table[hashValue];
-            int done = 0;
-            while (node != NULL && !done)
-            {
-                if ((item->key) > (node->key) && node->next == NULL)
-                {
-                    node->next = item;
-                    done = 1;
-                }
-                else if (node->next != NULL && (item->key) < (node->next->key) && (item->key) > (node->key))
-                {
-                    item->next = node->next;
-                    node->next = item;
-                    done = 1;
-                }
-                else if (item->key < node->key)
-                {
-                    item->next = node;
-                    table->table[hashValue] = item;
-                    done = 1;
-                }
-                else if (item->key == node->key) // Item is the same as the node
-                {
-                    node->value = item->value;
-                    free(item);
-                    table->numberOfItemsInTable--; // Cancel out addition at end of function
-                    done = 1;
-                }
-                node = node->next;
-            }
+            unsigned int arraySize = table->arraySize;
+            while ((table->numberOfItemsInTable + 1) > arraySize * HASHTABLE_MAX_LOAD_FACTOR)
+                arraySize *= 2;
+            if (_hashtable_rebuild(table, arraySize))
+                return;
+            slot = _hashtable_find_slot(table, key, hash);
         }
 
-        // Update the number of items in the table and current load factor
-        table->numberOfItemsInTable++;
-        table->currentLoadFactor = _hashtable_get_load_factor(table);
-
-        // Expand the table if needed
-        if (table->currentLoadFactor - HASHTABLE_DEFAULT_MAX_POSITIVE_LOAD_FACTOR_VARIANCE > HASHTABLE_DEFAULT_LOAD_FACTOR)
-            _hashtable_double_table(table);
-    }
-}
-
-
-/**
- * Get an element from the hashtable based on the specified key
- * 
- * @param table The table in which to search for the key
- * @param key The key corresponsing to the value that will be returned
- * @return The value corresponding to the key specified 
- *         (NULL if table is NULL or it element does not exist)
- */
-void *hashtable_get(hashtable_t *table, unsigned long key)
-{
-    if (table != NULL)
-    {
-        // Calculate the location in the table
-        unsigned int hashValue = _hashtable_compute_index(table, key);
-        hashtable_entry_t *node = table->table[hashValue];
-
-        while (node != NULL)
+        // Grow the entry array
+        if (table->numberOfEntries == table->entriesSize)
         {
-            if (node->key == key)
-                return node->value;
-            node = node->next;
+            unsigned int entriesSize = table->entriesSize * 2;
+            hashtable_entry_t *entries = realloc(table->entries, sizeof(*entries) * entriesSize);
+            if (entries == NULL)
+                return;
+            table->entries = entries;
+            table->entriesSize = entriesSize;
         }
+
+        item = &(table->entries[table->numberOfEntries++]);
+        item->key = key;
+        item->hash = hash;
+        item->value = value;
+        table->slots[slot] = table->numberOfEntries;
+        table->numberOfItemsInTable++;
     }
-    return NULL;
 }
 
 
@@ -239,129 +121,41 @@ void *hashtable_get(hashtable_t *table, unsigned long key)
  * @return The value corresponding to the key specified 
  *         (NULL if table is NULL or it element does not exist)
  */
-void *hashtable_sget(hashtable_t *table, char *key)
+void *hashtable_sget(hashtable_t *table, const char *key)
 {
     if (table != NULL && key != NULL)
     {
-        // Calculate the location in the table
-        unsigned long keyi = hashtable_hash_string(key);
-        unsigned int hashValue = _hashtable_compute_index(table, keyi);
-        hashtable_entry_t *node = table->table[hashValue];
-
-        while (node != NULL)
-        {
-            if (node->key == keyi)
-                return node->value;
-            node = node->next;
-        }
+        unsigned int slot = _hashtable_find_slot(table, key, hashtable_hash_string(key));
+        if (table->slots[slot] != 0)
+            return table->entries[table->slots[slot] - 1].value;
     }
     return NULL;
 }
 
 
 /**
- * Remove an item from the table
+ * Remove an item from the table. The entry stays in the
+ * entry array (with a NULL key) until the table is rebuilt
+ * so that the insertion order of the others is kept.
  * 
  * @param table The table from which to remove an element
  * @param key The key for the value to be removed
  * @return The value associated with the key, NULL if no such element exists
  */
-void *hashtable_remove(hashtable_t *table, unsigned long key)
+void *hashtable_sremove(hashtable_t *table, const char *key)
 {
-    if (table != NULL)
+    if (table != NULL && key != NULL)
     {
-        // Calculate location in the table
-        unsigned int hashValue = _hashtable_compute_index(table, key);
-        hashtable_entry_t *node = table->table[hashValue];
-
-        hashtable_entry_t *previousNode = NULL;
-
-        while (node != NULL)
+        unsigned int slot = _hashtable_find_slot(table, key, hashtable_hash_string(key));
+        if (table->slots[slot] != 0)
         {
-            if (node->key == key)
-            {
-                if (previousNode == NULL)
-                {
-                    table->table[hashValue] = node->next;
-                    if (node->next == NULL)
-                        table->numberOfSlotsUsed--;
-                }
-                else
-                {
-                    previousNode->next = node->next;
-                }
-
-                // Update the number of items in the table and current load factor
-                table->numberOfItemsInTable--;
-                table->currentLoadFactor = ((float)table->numberOfSlotsUsed) / ((float)table->arraySize);
-                
-                // Shrink table if needed
-                if (table->currentLoadFactor + HASHTABLE_DEFAULT_MAX_NGATIVE_LOAD_FACTOR_VARIANCE < HASHTABLE_DEFAULT_LOAD_FACTOR)
-                    _hashtable_half_table(table);
-
-                void *returnValue = node->value;
-                /* free(node->value); */
-                free(node);
-                return returnValue; 
-            }
-
-            previousNode = node;
-            node = node->next;
-        }
-    }
-    return NULL; // Not Found
-}
-
+            hashtable_entry_t *item = &(table->entries[table->slots[slot] - 1]);
 
-/**
- * Remove an item from the table
- * 
- * @param table The table from which to remove an element
- * @param key The key for the value to be removed
- * @return The value associated with the key, NULL if no such element exists
- */
-void *hashtable_sremove(hashtable_t *table, char *key)
-{
-    if (table != NULL)
-    {
-        // Calculate location in the table
-        unsigned long keyi = hashtable_hash_string(key);
-        unsigned int hashValue = _hashtable_compute_index(table, keyi);
-        hashtable_entry_t *node = table->table[hashValue];
-
-        hashtable_entry_t *previousNode = NULL;
-
-        while (node != NULL)
-        {
-            if (node->key == keyi)
-            {
-                if (previousNode == NULL)
-                {
-                    table->table[hashValue] = node->next;
-                    if (node->next == NULL)
-                        table->numberOfSlotsUsed--;
-                }
-                else
-                {
-                    previousNode->next = node->next;
-                }
-
-                // Update the number of items in the table and current load factor
-                table->numberOfItemsInTable--;
-                table->currentLoadFactor = ((float)table->numberOfSlotsUsed) / ((float)table->arraySize);
-
-                // Shrink table if needed
-                if (table->currentLoadFactor + HASHTABLE_DEFAULT_MAX_NGATIVE_LOAD_FACTOR_VARIANCE < HASHTABLE_DEFAULT_LOAD_FACTOR)
-                    _hashtable_half_table(table);
-
-                void *returnValue = node->value;
-                /* free(node->value); */
-                free(node);
-                return returnValue;
-            }
-
-            previousNode = node;
-            node = node->next;
+            // The slot keeps pointing at the removed entry so
+            // that probe sequences passing through it still work
+            item->key = NULL;
+            table->numberOfItemsInTable--;
+            return item->value;
         }
     }
     return NULL; // Not Found
@@ -376,56 +170,20 @@ void *hashtable_sremove(hashtable_t *table, char *key)
  * @return 1 if the key is found, 
  *         0 if not found or if table is NULL
  */
-unsigned int hashtable_contains_key(hashtable_t *table, unsigned long key)
-{
-    if (table != NULL)
-    {
-        // Calculate location in the hashtable
-        unsigned int hashValue = _hashtable_compute_index(table, key);
-        hashtable_entry_t *node = table->table[hashValue];
-
-        while (node != NULL)
-        {
-            if (node->key == key)
-                return 1;
-            node = node->next;
-        }
-    }
-    return 0;
-}
-
-
-/**
- * Search if a key exists
- * 
- * @param table The table in which to check for the key
- * @param key The key to search for
- * @return 1 if the key is found, 
- *         0 if not found or if table is NULL
- */
-unsigned int hashtable_contains_skey(hashtable_t *table, char *key)
+unsigned int hashtable_contains_skey(hashtable_t *table, const char *key)
 {
-    if (table != NULL)
+    if (table != NULL && key != NULL)
     {
-        // Calculate location in the hashtable
-        unsigned long keyi = hashtable_hash_string(key);
-        unsigned int hashValue = _hashtable_compute_index(table, keyi);
-        hashtable_entry_t *node = table->table[hashValue];
-
-        while (node != NULL)
-        {
-            if (node->key == keyi)
-                return 1;
-            node = node->next;
-        }
+        unsigned int slot = _hashtable_find_slot(table, key, hashtable_hash_string(key));
+        return table->slots[slot] != 0;
     }
     return 0;
 }
 
 
 /**
- * Free a HashTable. 
- * Also free()s any values of any elements in the table
+ * Free a HashTable.
+ * The keys and values of the elements are NOT free()d
  * 
  * @param table The table to free
  */
@@ -433,15 +191,8 @@ void hashtable_destroy(hashtable_t **table)
 {
     if (table != NULL && *table != NULL)
     {
-        for (unsigned int i = 0; i < (*table)->arraySize; i++)
-        {
-            if ((*table)->table[i] != NULL)
-            {
-                free(((*table)->table[i])->value);
-            }
-            free((*table)->table[i]);
-        }
-        free((*table)->table);
+        free((*table)->entries);
+        free((*table)->slots);
         free(*table);
         *table = NULL;
     }
@@ -459,7 +210,7 @@ unsigned int hashtable_is_empty(hashtable_t *table)
 {
     if (table != NULL)
     {
-        return (table->arraySize) == 0;
+        return (table->numberOfItemsInTable) == 0;
     }
     return 0;
 }
@@ -507,126 +258,109 @@ unsigned long hashtable_hash_string(const char *string)
 
 
 /**
- * Computes the pointer offset of a specified key into 
- * the hash table internal array
+ * Measure the probe lengths of the keys of a table. The
+ * probe length of a key is the number of slots looked at
+ * to find it, 1 if it is in its home slot.
  * 
- * @param key The key to be "hashed"
- * @return The hash of the key 
- *         0 if the input table is NULL
+ * @param table The table to measure (may be NULL)
+ * @param stats Set to the measurements
+ * @return none
  */
-static unsigned int _hashtable_compute_index(hashtable_t *table, unsigned long key)
+void hashtable_get_stats(hashtable_t *table, hashtable_stats_t *stats)
 {
-    if (table != NULL)
-    {
-        return key % (table->arraySize);
-    }
-    return 0;
-}
+    unsigned long total = 0;
+    unsigned int i, mask, probe;
 
+    memset(stats, 0, sizeof(*stats));
+    if (table == NULL)
+        return;
 
-// /**
-//  * Get the average collision list length of the table
-//  * 
-//  * @param table The table to check collision list length average
-//  * @return The average collision length of the collision lists in the table
-//  *         -1 if the input table is NULL
-//  */
-// static float _hashtable_get_collision_average(hashtable_t *table)
-// {
-//     if (table != NULL)
-//     {
-//         return ((float)table->numberOfItemsInTable) / ((float)table->arraySize);
-//     }
-//     return -1;
-// }
-
-
-/**
- * Get the current table's load factor
- * 
- * @param table The table to check its load factor
- * @return The provided table's load factor
- *         -1 if the input table is NULL
- */
-static float _hashtable_get_load_factor(hashtable_t *table)
-{
-    if (table != NULL)
+    mask = table->arraySize - 1;
+    for (i = 0; i < table->arraySize; i++)
     {
-        return ((float)(table->numberOfItemsInTable)) / ((float)(table->arraySize));
+        if (table->slots[i] == 0 || table->entries[table->slots[i] - 1].key == NULL)
+            continue;
+        probe = ((i - (unsigned int)table->entries[table->slots[i] - 1].hash) & mask) + 1;
+        total += probe;
+        if (probe > stats->maxProbe)
+            stats->maxProbe = probe;
     }
-    return -1;
+    stats->items = table->numberOfItemsInTable;
+    stats->slots = table->arraySize;
+    if (stats->items)
+        stats->meanProbe = (double)total / stats->items;
 }
 
 
 /**
- * Doubles the size of the array for the specified hashtable
+ * Find the slot holding a key, or the empty slot where it
+ * would be inserted
  * 
- * @param table The table to be doubled in size
+ * @param table The table to search
+ * @param key The key to search for
+ * @param hash The hash of the key
+ * @return The index of the slot
  */
-static void _hashtable_double_table(hashtable_t *table)
+static unsigned int _hashtable_find_slot(hashtable_t *table, const char *key, unsigned long hash)
 {
-    if (table != NULL)
-    {
-        // Keep a reference to the old table in the iterator
-        hashtable_itr_t *itr = hashtable_create_iterator(table);
-        table->arraySize = table->arraySize * 2;
-        table->table = malloc(sizeof(hashtable_entry_t *) * table->arraySize);
+    unsigned int mask = table->arraySize - 1;
+    unsigned int slot = hash & mask;
+    hashtable_entry_t *item;
 
-        // Reset the values
-        table->currentLoadFactor = 0;
-        table->numberOfItemsInTable = 0;
-        table->numberOfSlotsUsed = 0;
-
-        for (unsigned int i = 0; i < table->arraySize; i++)
-            table->table[i] = NULL;
-
-        // Loop throught the original table and rehash them into the new table
-        while (hashtable_iterator_has_next(itr))
-        {
-            hashtable_entry_t *node = hashtable_iterator_next(itr);
-            hashtable_put(table, node->key, node->value);
-        }
-        hashtable_iterator_free(&itr);
+    while (table->slots[slot] != 0)
+    {
+        item = &(table->entries[table->slots[slot] - 1]);
+        if (item->key != NULL && item->hash == hash && strcmp(item->key, key) == 0)
+            return slot;
+        slot = (slot + 1) & mask;
     }
+    return slot;
 }
 
 
 /**
- * Halve the size of the array for holding elements in the specified HashTable
+ * Rebuild the slot array with the given number of slots.
+ * Removed entries are dropped from the entry array.
+ * The old slot array is free()d.
  * 
- * @param table The table to be halved
+ * @param table The table to rebuild
+ * @param arraySize The new number of slots (power of 2)
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
  */
-static void _hashtable_half_table(hashtable_t *table)
+static int _hashtable_rebuild(hashtable_t *table, unsigned int arraySize)
 {
-    if (table != NULL && (table->arraySize) >= (2 * HASHTABLE_INITIAL_SIZE))
-    {
-        // Keep a reference to the old table in the iterator
-        hashtable_itr_t *itr = hashtable_create_iterator(table);
+    unsigned int *slots = calloc(arraySize, sizeof(*slots));
+    unsigned int i, j, slot;
 
-        table->arraySize = (table->arraySize) / 2;
-        table->table = malloc(sizeof(hashtable_entry_t *) * table->arraySize);
+    if (slots == NULL)
+        return 1;
 
-        // Reset the values
-        table->currentLoadFactor = 0;
-        table->numberOfItemsInTable = 0;
-        table->numberOfSlotsUsed = 0;
-
-        for (unsigned int i = 0; i < table->arraySize; i++)
-            table->table[i] = NULL;
+    free(table->slots);
+    table->slots = slots;
+    table->arraySize = arraySize;
 
-        // Loop through all the values in the original table, rehashing them into the new one
-        while (hashtable_iterator_has_next(itr))
-        {
-            hashtable_entry_t *node = hashtable_iterator_next(itr);
-            hashtable_put(table, node->key, node->value);
-        }
-        hashtable_iterator_free(&itr);
+    // Compact the entries and reinsert them in order
+    for (i = 0, j = 0; i < table->numberOfEntries; i++)
+    {
+        if (table->entries[i].key == NULL)
+            continue;
+        table->entries[j] = table->entries[i];
+        j++;
+
+        slot = table->entries[j - 1].hash & (arraySize - 1);
+        while (slots[slot] != 0)
+            slot = (slot + 1) & (arraySize - 1);
+        slots[slot] = j;
     }
+    table->numberOfEntries = j;
+    return 0;
 }
 
 
 /** 
- * Return a new HashTableIterator
+ * Return a new HashTableIterator. Elements are visited
+ * in the order they were added.
  * 
  * @param table The HashTable to create an Iterator from
  * @return A reference to the new HashTableIterator
@@ -637,13 +371,11 @@ hashtable_itr_t *hashtable_create_iterator(hashtable_t * table)
     if (table != NULL)
     {
         hashtable_itr_t *itr = (hashtable_itr_t *)malloc(sizeof(hashtable_itr_t));
-        itr->currentNode = table->table[0];
-        itr->currentTableIndex = 0;
-        itr->foundElements = 0;
-        itr->totalElements = table->numberOfItemsInTable;
-        itr->tableSize = table->arraySize;
-        itr->iteratorTable = table->table;
-        // memcpy(itr->iteratorTable, table->table, sizeof(hashtable_entry_t) * table->arraySize);
+        if (itr != NULL)
+        {
+            itr->table = table;
+            itr->currentIndex = 0;
+        }
         return itr;
     }
     return NULL;
@@ -661,9 +393,13 @@ int hashtable_iterator_has_next(hashtable_itr_t * itr)
 {
     if (itr != NULL)
     {
-        return ((itr->foundElements) < (itr->totalElements)) && 
-                ((itr->currentTableIndex) < (itr->tableSize) ||
-                ((itr->currentNode) != NULL && (itr->currentNode)->next != NULL));
+        // Skip over removed entries
+        while (itr->currentIndex < itr->table->numberOfEntries &&
+               itr->table->entries[itr->currentIndex].key == NULL)
+        {
+            ++itr->currentIndex;
+        }
+        return itr->currentIndex < itr->table->numberOfEntries;
     }
     return 0;
 }
@@ -678,24 +414,9 @@ int hashtable_iterator_has_next(hashtable_itr_t * itr)
  */
 hashtable_entry_t *hashtable_iterator_next(hashtable_itr_t * itr)
 {
-    if (itr != NULL)
+    if (hashtable_iterator_has_next(itr))
     {
-        if (hashtable_iterator_has_next(itr))
-        {
-            if (itr->currentNode != NULL)
-            {
-                hashtable_entry_t *returnNode = itr->currentNode;
-                itr->currentNode = itr->currentNode->next;
-                ++itr->foundElements;
-                return returnNode;
-            }
-            else
-            {
-                itr->currentNode = itr->iteratorTable[++(itr->currentTableIndex)];
-                return hashtable_iterator_next(itr);
-            }
-        }
-        return NULL;
+        return &(itr->table->entries[itr->currentIndex++]);
     }
     return NULL;
 }
@@ -714,4 +435,3 @@ void hashtable_iterator_free(hashtable_itr_t **itr)
         (*itr) = NULL;
     }
 }
-
@@ -10,58 +10,60 @@
 #include <stdlib.h>
 #include <stddef.h> // NULL
 
-#define HASHTABLE_DEFAULT_MAX_POSITIVE_LOAD_FACTOR_VARIANCE 0.2
-#define HASHTABLE_DEFAULT_MAX_NGATIVE_LOAD_FACTOR_VARIANCE 0.5
-#define HASHTABLE_DEFAULT_LOAD_FACTOR 1.0
+#define HASHTABLE_MAX_LOAD_FACTOR 0.5
 #define HASHTABLE_INITIAL_SIZE 16
 
+/*
+ * Entries are stored in a flat array in insertion order.
+ * The slot array is an open addressed (linear probing)
+ * index into the entries. Keys are compared in full, not
+ * only by their hash.
+ */
 typedef struct hashtable_t 
 {
-    float currentLoadFactor;            // Load factor
     unsigned int numberOfItemsInTable;  // Number of items in the table
-    unsigned int numberOfSlotsUsed;     // Number of table slots that have had data in them ("dirty slots")
-    unsigned int arraySize;             // Current size of array to store elements
-    struct hashtable_entry_t **table;   // The table in which to store the elements
+    unsigned int numberOfEntries;       // Number of used entries (including removed ones)
+    unsigned int entriesSize;           // Allocated size of the entry array
+    unsigned int arraySize;             // Number of slots (power of 2)
+    struct hashtable_entry_t *entries;  // Entries in insertion order
+    unsigned int *slots;                // Entry index + 1 for each slot (0 = empty)
 } hashtable_t;
 
 typedef struct hashtable_entry_t
 {
-    struct hashtable_entry_t *next;     // Using collision lists, this points to the next node in the list
-    unsigned long key;
+    char *key;                          // NULL if the entry was removed
+    unsigned long hash;
     void *value;
 } hashtable_entry_t;
 
+// How well the keys of a table are spread over its slots
+typedef struct hashtable_stats_t
+{
+    unsigned int items;                 // Keys in the table
+    unsigned int slots;                 // Number of slots
+    unsigned int maxProbe;              // Most slots looked at to find a key
+    double meanProbe;                   // Mean slots looked at to find a key
+} hashtable_stats_t;
+
 typedef struct hashtable_itr_t
 {
-    int currentTableIndex;
-    int foundElements;
-    int totalElements;
-    int tableSize;
-    struct hashtable_entry_t *currentNode;
-    struct hashtable_entry_t **iteratorTable;
+    hashtable_t *table;
+    unsigned int currentIndex;          // Next entry to look at
 } hashtable_itr_t;
 
 
 // Function Prototypes
 int hashtable_init(hashtable_t **table);
 void hashtable_clear(hashtable_t *table);
-void hashtable_put(hashtable_t *table, unsigned long key, void *value);
 void hashtable_sput(hashtable_t *table, char *key, void *value);
-void *hashtable_get(hashtable_t *table, unsigned long key);
-void *hashtable_sget(hashtable_t *table, char *key);
-void *hashtable_remove(hashtable_t *table, unsigned long key);
-void *hashtable_sremove(hashtable_t *table, char *key);
-unsigned int hashtable_contains_key(hashtable_t *table, unsigned long key);
-unsigned int hashtable_contains_skey(hashtable_t *table, char *key);
+void *hashtable_sget(hashtable_t *table, const char *key);
+void *hashtable_sremove(hashtable_t *table, const char *key);
+unsigned int hashtable_contains_skey(hashtable_t *table, const char *key);
 void hashtable_destroy(hashtable_t **table);
 unsigned int hashtable_is_empty(hashtable_t *table);
 unsigned int hashtable_get_num_elements(hashtable_t *table);
 unsigned long hashtable_hash_string(const char *string);
-static unsigned int _hashtable_compute_index(hashtable_t *table, unsigned long key);
-// static float _hashtable_get_collision_average(hashtable_t *table);
-static float _hashtable_get_load_factor(hashtable_t *table);
-static void _hashtable_double_table(hashtable_t *table);
-static void _hashtable_half_table(hashtable_t *table);
+void hashtable_get_stats(hashtable_t *table, hashtable_stats_t *stats);
 
 hashtable_itr_t *hashtable_create_iterator(hashtable_t *table);
 int hashtable_iterator_has_next(hashtable_itr_t *itr);
@@ -0,0 +1,506 @@
+/**
+ * VeriFrog declaration imports
+ *
+ * An import reads the module, tick and net declarations of
+ * another file into the compilation. With a cache directory,
+ * the first time a file is imported its declarations are
+ * also written in a precompiled form, kept as <hash>.vfp
+ * in the cache directory. Later imports of the same text
+ * load that instead of parsing the file again. Without one
+ * nothing is written; imports are always parsed.
+ *
+ * A precompiled file holds (numbers are big-endian 32 bit,
+ * strings a number of bytes followed by the bytes):
+ *
+ *   "VFPD", VF_VERSION, the hash of the imported text
+ *   (64 bit), the module name, the clock net, the tick
+ *   size, the tick units, the clock port flag, the number
+ *   of nets and for each net its width, its direction and
+ *   its name.
+ *
+ * An empty module name or clock net means it is not
+ * declared.
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "verifrog.h"
+#include "arena.h"
+#include "intern.h"
+#include "cache.h"
+#include "import.h"
+#include "parse.tab.h"
+#include "lex.yy.h"
+
+#define IMPORT_MAGIC "VFPD"
+
+// Reads a precompiled file, any read past the end sets bad
+typedef struct _reader_t {
+	const unsigned char *p;
+	const unsigned char *end;
+	int bad;
+} _reader_t;
+
+static char *_resolve(vf_ctx_t *ctx, const char *name);
+static char *_precompiled_path(vf_ctx_t *ctx, uint64_t hash);
+static import_decls_t *_new_decls(vf_ctx_t *ctx);
+static void _add_net(vf_ctx_t *ctx, import_decls_t *d, char *net, int width, int output);
+static void _parse(vf_ctx_t *ctx, char *path, import_decls_t *d);
+static int _load(vf_ctx_t *ctx, const char *pre, uint64_t hash, import_decls_t *d);
+static void _apply(vf_ctx_t *ctx, const import_decls_t *d);
+static int _store(vf_ctx_t *ctx, const char *pre, uint64_t hash, const import_decls_t *d);
+static uint32_t _get32(_reader_t *r);
+static char *_get_str(vf_ctx_t *ctx, _reader_t *r);
+static void _put32(FILE *f, uint32_t v);
+static void _put_str(FILE *f, const char *s);
+
+
+/**
+ * Import the declarations of a file, from its precompiled
+ * form in the cache directory when that is up to date. The
+ * file is added to the imports of the compilation.
+ *
+ * @param *ctx The compilation context
+ * @param *name The file name, relative to the importing file
+ * @return none
+ */
+void import_file(vf_ctx_t *ctx, const char *name) {
+
+    char *path = _resolve(ctx, name);
+    import_decls_t *d = _new_decls(ctx);
+    import_t *imp = arena_alloc(ctx->session_arena, sizeof(*imp));
+    uint64_t hash;
+    char *pre;
+
+    if (!imp) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "unable to allocate import '%s'", name);
+        vf_error(ctx);
+    }
+    if (input_open(&(ctx->import_input), path)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "unable to open import '%s' on line %d", path, ctx->linenum);
+        vf_error(ctx);
+    }
+
+    hash = cache_hash(CACHE_FNV_OFFSET, ctx->import_input.buf, ctx->import_input.size);
+    imp->path = path;
+    imp->hash = hash;
+    imp->n = ctx->imports;
+    ctx->imports = imp;
+
+    // Precompiled files are only kept in the cache directory,
+    // never next to the sources
+    if (!ctx->cache_dir) {
+        _parse(ctx, path, d);
+        input_close(&(ctx->import_input));
+        return;
+    }
+
+    pre = _precompiled_path(ctx, hash);
+    if (!_load(ctx, pre, hash, d)) {
+        DIAG(&(ctx->diag), DIAG_INFO, DIAG_CAT_PARSE,
+             "Loaded precompiled import '%s'", pre);
+        _apply(ctx, d);
+    } else {
+        _parse(ctx, path, d);
+        if (_store(ctx, pre, hash, d)) {
+            DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_PARSE,
+                 "unable to store precompiled import '%s'", pre);
+        }
+    }
+
+    input_close(&(ctx->import_input));
+}
+
+
+/**
+ * Record the module declared by the import being parsed
+ *
+ * @param *ctx The compilation context
+ * @param *name The interned module name
+ * @return none
+ */
+void import_record_module(vf_ctx_t *ctx, char *name) {
+    ctx->import_decls->module_name = name;
+}
+
+
+/**
+ * Record the tick declared by the import being parsed
+ *
+ * @param *ctx The compilation context
+ * @param *cnet The interned clock net name
+ * @param time The tick length in units
+ * @param *units The interned time units
+ * @param use_port 1 = the clock is a port of the module
+ * @return none
+ */
+void import_record_tick(vf_ctx_t *ctx, char *cnet, int time, char *units, int use_port) {
+    import_decls_t *d = ctx->import_decls;
+
+    d->clock_net = cnet;
+    d->tick_size = time;
+    d->tick_units = units;
+    d->use_clk_port = use_port;
+}
+
+
+/**
+ * Record a net declared by the import being parsed
+ *
+ * @param *ctx The compilation context
+ * @param *net The interned net name
+ * @param width The width of the net in bits
+ * @param output 1 = output net
+ *               0 = input net
+ * @return none
+ */
+void import_record_net(vf_ctx_t *ctx, char *net, int width, int output) {
+    _add_net(ctx, ctx->import_decls, net, width, output);
+}
+
+
+/**
+ * Get the path of an imported file. Relative names are
+ * relative to the directory of the input file.
+ *
+ * @param *ctx The compilation context
+ * @param *name The name given to import
+ * @return The path (in the session arena)
+ */
+static char *_resolve(vf_ctx_t *ctx, const char *name) {
+
+    const char *slash = strrchr(ctx->input_file, '/');
+    size_t dir = 0;
+    char *path;
+
+    if (name[0] != '/' && slash) {
+        dir = slash - ctx->input_file + 1;
+    }
+    path = arena_alloc(ctx->session_arena, dir + strlen(name) + 1);
+    if (!path) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "unable to allocate import '%s'", name);
+        vf_error(ctx);
+    }
+    memcpy(path, ctx->input_file, dir);
+    strcpy(path + dir, name);
+    return path;
+}
+
+
+/**
+ * Get the path of the precompiled form of an import in
+ * the cache directory
+ *
+ * @param *ctx The compilation context (with a cache directory)
+ * @param hash The hash of the text of the import
+ * @return The path (in the session arena)
+ */
+static char *_precompiled_path(vf_ctx_t *ctx, uint64_t hash) {
+
+    char *pre = arena_alloc(ctx->session_arena,
+                            strlen(ctx->cache_dir) + sizeof(IMPORT_EXT) + 18);
+
+    if (!pre) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE, "unable to allocate import");
+        vf_error(ctx);
+    }
+    sprintf(pre, "%s/%016llx" IMPORT_EXT, ctx->cache_dir, (unsigned long long)hash);
+    return pre;
+}
+
+
+/**
+ * Allocate empty declarations
+ */
+static import_decls_t *_new_decls(vf_ctx_t *ctx) {
+    import_decls_t *d = arena_alloc(ctx->session_arena, sizeof(*d));
+    if (!d) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE, "unable to allocate import");
+        vf_error(ctx);
+    }
+    memset(d, 0, sizeof(*d));
+    return d;
+}
+
+
+/**
+ * Add a net to the end of the declarations of an import
+ */
+static void _add_net(vf_ctx_t *ctx, import_decls_t *d, char *net, int width, int output) {
+
+    import_net_t *n = arena_alloc(ctx->session_arena, sizeof(*n));
+
+    if (!n) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "could not allocate symbol! '%s'", net);
+        vf_error(ctx);
+    }
+    n->name = net;
+    n->width = width;
+    n->output = output;
+    n->n = NULL;
+    if (d->nets_tail) {
+        d->nets_tail->n = n;
+    } else {
+        d->nets = n;
+    }
+    d->nets_tail = n;
+}
+
+
+/**
+ * Parse an imported file (in ctx->import_input) with a
+ * lexer of its own. Its declarations are made as they are
+ * parsed and recorded into d.
+ *
+ * @param *ctx The compilation context
+ * @param *path The imported file
+ * @param *d The declarations to record
+ * @return none
+ */
+static void _parse(vf_ctx_t *ctx, char *path, import_decls_t *d) {
+
+    unsigned int linenum = ctx->linenum;
+    int comment_level = ctx->comment_level;
+
+    ctx->importing = path;
+    ctx->import_decls = d;
+    ctx->linenum = 1;
+    ctx->comment_level = 0;
+
+    if (yylex_init_extra(ctx, (yyscan_t *)&(ctx->import_scanner))) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE, "unable to allocate lexer");
+        vf_error(ctx);
+    }
+    if (!yy_scan_buffer(ctx->import_input.buf, ctx->import_input.size + INPUT_PAD,
+                        ctx->import_scanner)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE, "unable to allocate lexer buffer");
+        vf_error(ctx);
+    }
+    if (yyparse(ctx->import_scanner, ctx)) {
+        vf_error(ctx);
+    }
+    yylex_destroy(ctx->import_scanner);
+    ctx->import_scanner = NULL;
+
+    ctx->importing = NULL;
+    ctx->import_decls = NULL;
+    ctx->linenum = linenum;
+    ctx->comment_level = comment_level;
+}
+
+
+/**
+ * Read the precompiled declarations of an import
+ *
+ * @param *ctx The compilation context
+ * @param *pre The precompiled file
+ * @param hash The hash of the text of the import
+ * @param *d Filled in with the declarations
+ * @return 0 on success
+ *         1 if there is no precompiled file, or it is out
+ *           of date or unreadable
+ */
+static int _load(vf_ctx_t *ctx, const char *pre, uint64_t hash, import_decls_t *d) {
+
+    input_t in;
+    _reader_t r;
+    uint32_t count, width, output;
+    uint64_t h;
+    char *version, *name;
+
+    if (input_open(&in, pre)) {
+        return 1;
+    }
+    r.p = (const unsigned char *)in.buf;
+    r.end = r.p + in.size;
+    r.bad = 0;
+
+    if (in.size < sizeof(IMPORT_MAGIC) - 1 ||
+        memcmp(r.p, IMPORT_MAGIC, sizeof(IMPORT_MAGIC) - 1)) {
+        input_close(&in);
+        return 1;
+    }
+    r.p += sizeof(IMPORT_MAGIC) - 1;
+
+    version = _get_str(ctx, &r);
+    h = (uint64_t)_get32(&r) << 32;
+    h |= _get32(&r);
+    if (r.bad || strcmp(version, VF_VERSION) || h != hash) {
+        input_close(&in);
+        return 1;
+    }
+
+    d->module_name = _get_str(ctx, &r);
+    d->clock_net = _get_str(ctx, &r);
+    d->tick_size = _get32(&r);
+    d->tick_units = _get_str(ctx, &r);
+    d->use_clk_port = _get32(&r);
+    count = _get32(&r);
+    while (count-- && !r.bad) {
+        width = _get32(&r);
+        output = _get32(&r);
+        name = _get_str(ctx, &r);
+        if (!r.bad) {
+            _add_net(ctx, d, name, width, output);
+        }
+    }
+    input_close(&in);
+
+    if (r.bad || r.p != r.end) {
+        memset(d, 0, sizeof(*d));
+        return 1;
+    }
+    if (!d->module_name[0]) {
+        d->module_name = NULL;
+    }
+    if (!d->clock_net[0]) {
+        d->clock_net = NULL;
+    }
+    return 0;
+}
+
+
+/**
+ * Make the declarations of an import
+ *
+ * @param *ctx The compilation context
+ * @param *d The declarations
+ * @return none
+ */
+static void _apply(vf_ctx_t *ctx, const import_decls_t *d) {
+
+    import_net_t *n;
+
+    if (d->module_name) {
+        vf_declare_module(ctx, d->module_name);
+    }
+    if (d->clock_net) {
+        vf_declare_tick(ctx, d->clock_net, d->tick_size, d->tick_units,
+                        d->use_clk_port);
+    }
+    for (n = d->nets; n; n = n->n) {
+        vf_declare_net(ctx, n->name, n->width, n->output);
+    }
+}
+
+
+/**
+ * Write the precompiled declarations of an import
+ *
+ * @param *ctx The compilation context (with a cache directory)
+ * @param *pre The precompiled file
+ * @param hash The hash of the text of the import
+ * @param *d The declarations
+ * @return 0 on success
+ *         1 on failure
+ */
+static int _store(vf_ctx_t *ctx, const char *pre, uint64_t hash, const import_decls_t *d) {
+
+    outfile_t o;
+    import_net_t *n;
+    uint32_t count = 0;
+
+    if (mkdir(ctx->cache_dir, 0777) && errno != EEXIST) {
+        return 1;
+    }
+    if (!outfile_open(&o, pre)) {
+        return 1;
+    }
+
+    for (n = d->nets; n; n = n->n) {
+        ++count;
+    }
+
+    fputs(IMPORT_MAGIC, o.f);
+    _put_str(o.f, VF_VERSION);
+    _put32(o.f, hash >> 32);
+    _put32(o.f, hash & 0xffffffff);
+    _put_str(o.f, d->module_name ? d->module_name : "");
+    _put_str(o.f, d->clock_net ? d->clock_net : "");
+    _put32(o.f, d->tick_size);
+    _put_str(o.f, d->clock_net ? d->tick_units : "");
+    _put32(o.f, d->use_clk_port);
+    _put32(o.f, count);
+    for (n = d->nets; n; n = n->n) {
+        _put32(o.f, n->width);
+        _put32(o.f, n->output);
+        _put_str(o.f, n->name);
+    }
+
+    return outfile_close(&o);
+}
+
+
+/**
+ * Read a big-endian 32 bit number
+ */
+static uint32_t _get32(_reader_t *r) {
+    uint32_t v;
+
+    if (r->end - r->p < 4) {
+        r->bad = 1;
+        return 0;
+    }
+    v = ((uint32_t)r->p[0] << 24) | ((uint32_t)r->p[1] << 16) |
+        ((uint32_t)r->p[2] << 8) | r->p[3];
+    r->p += 4;
+    return v;
+}
+
+
+/**
+ * Read a string and intern it. Returns "" on failure.
+ */
+static char *_get_str(vf_ctx_t *ctx, _reader_t *r) {
+    uint32_t len = _get32(r);
+    char *s;
+
+    if (r->bad || (uint32_t)(r->end - r->p) < len) {
+        r->bad = 1;
+        return "";
+    }
+    s = intern_str(ctx->strings, (const char *)r->p, len);
+    if (!s) {
+        r->bad = 1;
+        return "";
+    }
+    r->p += len;
+    return s;
+}
+
+
+/**
+ * Write a big-endian 32 bit number
+ */
+static void _put32(FILE *f, uint32_t v) {
+    unsigned char b[4];
+
+    b[0] = (v >> 24) & 0xff;
+    b[1] = (v >> 16) & 0xff;
+    b[2] = (v >> 8) & 0xff;
+    b[3] = v & 0xff;
+    fwrite(b, 1, sizeof(b), f);
+}
+
+
+/**
+ * Write a string
+ */
+static void _put_str(FILE *f, const char *s) {
+    uint32_t len = strlen(s);
+
+    _put32(f, len);
+    fwrite(s, 1, len, f);
+}
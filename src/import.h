@@ -0,0 +1,56 @@
+/**
+ * VeriFrog declaration imports header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_IMPORT_H
+#define VERIFROG_IMPORT_H
+
+#include <stdint.h>
+
+// Appended to the hash of an imported file to name its
+// precompiled declarations in the cache directory
+#define IMPORT_EXT ".vfp"
+
+// A net declared by an import
+typedef struct import_net_t {
+	char *name;
+	int width;
+	int output;                     // 1 = output, 0 = input
+	struct import_net_t *n;
+} import_net_t;
+
+/*
+ * The declarations of an imported file. Nets are kept in
+ * the order they are declared so that they get the same
+ * offsets whether the file is parsed or precompiled.
+ */
+typedef struct import_decls_t {
+	char *module_name;              // NULL if not declared
+	char *clock_net;                // NULL if no tick is declared
+	unsigned int tick_size;
+	char *tick_units;
+	int use_clk_port;
+	import_net_t *nets;
+	import_net_t *nets_tail;
+} import_decls_t;
+
+// A file imported by a compilation. Cached outputs are only
+// used while none of these files changed.
+typedef struct import_t {
+	char *path;
+	uint64_t hash;                  // Hash of the text of the file
+	struct import_t *n;
+} import_t;
+
+struct vf_ctx_t;
+
+void import_file(struct vf_ctx_t *ctx, const char *name);
+void import_record_module(struct vf_ctx_t *ctx, char *name);
+void import_record_tick(struct vf_ctx_t *ctx, char *cnet, int time, char *units,
+                        int use_port);
+void import_record_net(struct vf_ctx_t *ctx, char *net, int width, int output);
+
+#endif
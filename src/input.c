@@ -0,0 +1,157 @@
+/**
+ * VeriFrog source input
+ *
+ * A source file is mapped copy-on-write over a reservation
+ * of zero pages that is at least INPUT_PAD bytes longer
+ * than the file. The padding yy_scan_buffer() needs is then
+ * already in place, and the lexer can write its temporary
+ * terminators into the text without touching the file.
+ * Sources that can not be mapped (stdin, pipes) are read
+ * into a buffer instead.
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "input.h"
+
+#define INPUT_READ_SIZE 65536
+
+static int _input_read(input_t *in, FILE *f);
+
+
+/**
+ * Load the text of a source
+ *
+ * @param *in The input to fill in
+ * @param *path The file name, INPUT_STDIN for stdin
+ * @return 0 on success
+ *         1 on failure (unable to read the file)
+ */
+int input_open(input_t *in, const char *path) {
+
+    struct stat st;
+    size_t page, map_size;
+    char *base;
+    FILE *f;
+    int fd, err;
+
+    in->buf = NULL;
+    in->size = 0;
+    in->map_size = 0;
+
+    if (!strcmp(path, INPUT_STDIN)) {
+        return _input_read(in, stdin);
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 1;
+    }
+    if (fstat(fd, &st)) {
+        close(fd);
+        return 1;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        f = fdopen(fd, "r");
+        if (!f) {
+            close(fd);
+            return 1;
+        }
+        err = _input_read(in, f);
+        fclose(f);
+        return err;
+    }
+
+    page = sysconf(_SC_PAGESIZE);
+    map_size = ((size_t)st.st_size + INPUT_PAD + page - 1) / page * page;
+
+    base = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return 1;
+    }
+    if (st.st_size &&
+        mmap(base, st.st_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, map_size);
+        close(fd);
+        return 1;
+    }
+    close(fd);
+    madvise(base, map_size, MADV_SEQUENTIAL);
+
+    in->buf = base;
+    in->size = st.st_size;
+    in->map_size = map_size;
+    return 0;
+}
+
+
+/**
+ * Release the text of a source. Safe to call on an input
+ * that was never opened or is already closed.
+ *
+ * @param *in The input to close
+ * @return none
+ */
+void input_close(input_t *in) {
+    if (in->map_size) {
+        munmap(in->buf, in->map_size);
+    } else {
+        free(in->buf);
+    }
+    in->buf = NULL;
+    in->size = 0;
+    in->map_size = 0;
+}
+
+
+/**
+ * Read a stream into a buffer that doubles as needed
+ *
+ * @param *in The input to fill in
+ * @param *f The stream to read to its end
+ * @return 0 on success
+ *         1 on failure (read error or out of memory)
+ */
+static int _input_read(input_t *in, FILE *f) {
+
+    size_t size = INPUT_READ_SIZE;
+    size_t len = 0, n;
+    char *buf = NULL, *p;
+
+    do {
+        if (len + INPUT_READ_SIZE + INPUT_PAD > size || !buf) {
+            while (len + INPUT_READ_SIZE + INPUT_PAD > size) {
+                size *= 2;
+            }
+            p = realloc(buf, size);
+            if (!p) {
+                free(buf);
+                return 1;
+            }
+            buf = p;
+        }
+        n = fread(buf + len, 1, INPUT_READ_SIZE, f);
+        len += n;
+    } while (n == INPUT_READ_SIZE);
+
+    if (ferror(f)) {
+        free(buf);
+        return 1;
+    }
+    memset(buf + len, 0, INPUT_PAD);
+    in->buf = buf;
+    in->size = len;
+    return 0;
+}
@@ -0,0 +1,36 @@
+/**
+ * VeriFrog source input header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_INPUT_H
+#define VERIFROG_INPUT_H
+
+#include <stddef.h>
+
+// Name of the input file that reads stdin instead
+#define INPUT_STDIN "-"
+
+// Number of NUL bytes after the text, as needed by
+// yy_scan_buffer()
+#define INPUT_PAD 2
+
+/*
+ * The whole text of a source in memory, followed by
+ * INPUT_PAD NUL bytes so the lexer can scan it in place.
+ * Files are mapped, stdin is read into a buffer. The text
+ * stays valid (and writable) until input_close() so tokens
+ * can refer to it instead of copying it.
+ */
+typedef struct input_t {
+	char *buf;
+	size_t size;                    // Bytes of text, not counting the padding
+	size_t map_size;                // Size of the mapping, 0 if buf was malloc'd
+} input_t;
+
+int input_open(input_t *in, const char *path);
+void input_close(input_t *in);
+
+#endif
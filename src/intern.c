@@ -0,0 +1,158 @@
+/**
+ * VeriFrog string interning
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+
+static unsigned long _intern_hash(const char *s, size_t len);
+static int _intern_grow(intern_t *t);
+
+
+/**
+ * Initialize an empty intern table
+ * 
+ * @param **t Pointer to the table to be allocated
+ * @param *a The arena in which strings are stored
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+int intern_init(intern_t **t, arena_t *a)
+{
+    (*t) = malloc(sizeof(**t));
+    if (!(*t)) {
+        return 1;
+    }
+    (*t)->arena = a;
+    (*t)->size = INTERN_INITIAL_SIZE;
+    (*t)->count = 0;
+    (*t)->slots = calloc((*t)->size, sizeof(*((*t)->slots)));
+    (*t)->hashes = malloc(sizeof(*((*t)->hashes)) * (*t)->size);
+
+    if (!(*t)->slots || !(*t)->hashes) {
+        intern_destroy(t);
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * Get the interned copy of a string, adding it if it has
+ * not been seen before
+ * 
+ * @param *t The intern table
+ * @param *s The text (need not be null terminated)
+ * @param len The length of the text
+ * @return The null terminated interned string, NULL on
+ *         allocation failure. Must not be modified or free'd.
+ */
+char *intern_str(intern_t *t, const char *s, size_t len)
+{
+    unsigned long h = _intern_hash(s, len);
+    unsigned int i = h & (t->size - 1);
+    char *str;
+
+    // Linear probe until the string or an empty slot is found
+    while (t->slots[i]) {
+        if (t->hashes[i] == h &&
+            !strncmp(t->slots[i], s, len) && t->slots[i][len] == '\0') {
+            return t->slots[i];
+        }
+        i = (i + 1) & (t->size - 1);
+    }
+
+    str = arena_strndup(t->arena, s, len);
+    if (!str) {
+        return NULL;
+    }
+    t->slots[i] = str;
+    t->hashes[i] = h;
+    ++t->count;
+
+    // Keep the load factor at or below 1/2
+    if (t->count * 2 > t->size && _intern_grow(t)) {
+        return NULL;
+    }
+    return str;
+}
+
+
+/**
+ * Free an intern table. The strings stay in the arena.
+ * *t will be NULL following the operation.
+ * 
+ * @param **t Pointer to the table to be free'd
+ * @return none
+ */
+void intern_destroy(intern_t **t)
+{
+    if (t && *t) {
+        free((*t)->slots);
+        free((*t)->hashes);
+        free(*t);
+        *t = NULL;
+    }
+}
+
+
+/**
+ * FNV-1a hash of a string of known length
+ * 
+ * @param *s The text to hash
+ * @param len The length of the text
+ * @return The hash value
+ */
+static unsigned long _intern_hash(const char *s, size_t len)
+{
+    unsigned long h = 2166136261UL;
+    while (len--) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+
+/**
+ * Double the number of slots and reinsert every string
+ * 
+ * @param *t The table to grow
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+static int _intern_grow(intern_t *t)
+{
+    unsigned int size = t->size * 2;
+    char **slots = calloc(size, sizeof(*slots));
+    unsigned long *hashes = malloc(sizeof(*hashes) * size);
+    unsigned int i, j;
+
+    if (!slots || !hashes) {
+        free(slots);
+        free(hashes);
+        return 1;
+    }
+
+    for (i = 0; i < t->size; ++i) {
+        if (t->slots[i]) {
+            j = t->hashes[i] & (size - 1);
+            while (slots[j]) {
+                j = (j + 1) & (size - 1);
+            }
+            slots[j] = t->slots[i];
+            hashes[j] = t->hashes[i];
+        }
+    }
+    free(t->slots);
+    free(t->hashes);
+    t->slots = slots;
+    t->hashes = hashes;
+    t->size = size;
+    return 0;
+}
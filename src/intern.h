@@ -0,0 +1,34 @@
+/**
+ * VeriFrog string interning header
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_INTERN_H
+#define VERIFROG_INTERN_H
+
+#include <stddef.h>
+
+#include "arena.h"
+
+#define INTERN_INITIAL_SIZE 256
+
+/*
+ * Open addressed set of strings. Each distinct string is
+ * copied into the arena once and every later lookup of
+ * the same text returns that copy.
+ */
+typedef struct intern_t {
+	arena_t *arena;             // Holds the string copies
+	char **slots;               // Interned strings (NULL = empty)
+	unsigned long *hashes;      // Hash of the string in each slot
+	unsigned int size;          // Number of slots (power of 2)
+	unsigned int count;         // Number of strings held
+} intern_t;
+
+int intern_init(intern_t **t, arena_t *a);
+char *intern_str(intern_t *t, const char *s, size_t len);
+void intern_destroy(intern_t **t);
+
+#endif
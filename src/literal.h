@@ -8,10 +8,14 @@
 #ifndef VERIFROG_LITERAL_H
 #define VERIFROG_LITERAL_H
 
+#include <stddef.h>
+
+// Text of a literal block. It points into the source and
+// is not NUL terminated.
 typedef struct literal_t {
 	char *text;
-    int index;
-    struct literal_t *n;
+	size_t len;                     // Length of the text
+	struct literal_t *n;
 } literal_t;
 
 #endif
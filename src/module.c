@@ -0,0 +1,397 @@
+/**
+ * VeriFrog module blocks
+ *
+ * A source can describe several modules, each in a block
+ *
+ *   module NAME { declarations and statements }
+ *
+ * A block is parsed into the context of the whole file like
+ * a source with a single module. When the block ends, its
+ * symbols, schedule, generators, literals and data file
+ * state are moved into a context of its own and the file's
+ * context starts over. After parsing, the data and test
+ * bench files of all blocks are written at the same time,
+ * one block per thread.
+ *
+ * The outputs of a block are named after the outputs of the
+ * file with _NAME inserted before the extension, so block
+ * alu of plan.vfl writes plan_alu.dat and tb_plan_alu.v.
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "verifrog.h"
+#include "arena.h"
+#include "hashtable.h"
+#include "schedule.h"
+#include "gen.h"
+#include "datfile.h"
+#include "module.h"
+
+// Blocks shared by the threads writing their outputs
+typedef struct _module_work_t {
+	vf_ctx_t **mods;
+	unsigned int count;
+	unsigned int next;              // Next block to take
+	int stats;                      // Collect statistics of each block
+	int failed;
+} _module_work_t;
+
+static char *_module_path(vf_ctx_t *ctx, const char *path, const char *name);
+static int _top_is_empty(vf_ctx_t *ctx);
+static void *_module_worker(void *arg);
+static int _module_run(vf_ctx_t *m, int stats);
+
+
+/**
+ * Start a module block. Its outputs are set up and it is
+ * parsed into ctx until module_end().
+ *
+ * @param *ctx The compilation context
+ * @param *name The interned module name
+ * @return none
+ */
+void module_begin(vf_ctx_t *ctx, char *name) {
+
+    vf_ctx_t *m;
+
+    if (ctx->importing) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "module block '%s' in import '%s' on line %d",
+             name, ctx->importing, ctx->linenum);
+        vf_error(ctx);
+    }
+    if (ctx->module_open) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "module block '%s' inside module block '%s' on line %d",
+             name, ctx->module_name, ctx->linenum);
+        vf_error(ctx);
+    }
+    if (!_top_is_empty(ctx)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "module block '%s' on line %d follows declarations or statements "
+             "outside a module block", name, ctx->linenum);
+        vf_error(ctx);
+    }
+
+    m = malloc(sizeof(*m));
+    if (!m) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "unable to allocate module '%s'", name);
+        vf_error(ctx);
+    }
+    vf_ctx_init(m);
+    ctx->module_open = m;
+
+    m->input_file = ctx->input_file;
+    m->dat_file = _module_path(ctx, ctx->dat_file, name);
+    m->tb_file = _module_path(ctx, ctx->tb_file, name);
+    m->dat_format = ctx->dat_format;
+    m->stream = ctx->stream;
+    m->sparse = ctx->sparse;
+    m->stamp = ctx->stamp;
+    if (ctx->sparse) {
+        m->xpct_file = malloc(strlen(m->dat_file) + sizeof(VF_XPCT_EXT));
+        if (m->xpct_file) {
+            sprintf(m->xpct_file, "%s" VF_XPCT_EXT, m->dat_file);
+        }
+    }
+    if ((ctx->sparse && !m->xpct_file) ||
+        arena_init(&(m->session_arena)) || arena_init(&(m->scratch_arena))) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "unable to allocate module '%s'", name);
+        vf_error(ctx);
+    }
+
+    ctx->module_name = name;
+
+    // Streamed rows go to the data file of the block
+    if (ctx->stream) {
+        outfile_discard(&(ctx->out));
+        outfile_discard(&(ctx->xout));
+        if (!outfile_open(&(ctx->out), m->dat_file) ||
+            (ctx->sparse && !outfile_open(&(ctx->xout), m->xpct_file))) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+                 "Unable to open output file '%s'", m->dat_file);
+            vf_error(ctx);
+        }
+    }
+}
+
+
+/**
+ * End the module block being parsed. Everything parsed in
+ * the block moves into its context.
+ *
+ * @param *ctx The compilation context
+ * @return none
+ */
+void module_end(vf_ctx_t *ctx) {
+
+    vf_ctx_t *m = ctx->module_open;
+
+    m->module_name = ctx->module_name;
+    m->clock_net = ctx->clock_net;
+    m->tick_size = ctx->tick_size;
+    m->tick_units = ctx->tick_units;
+    m->use_clk_port = ctx->use_clk_port;
+    m->input_table = ctx->input_table;
+    m->output_table = ctx->output_table;
+    m->input_syms = ctx->input_syms;
+    m->output_syms = ctx->output_syms;
+    m->input_offset = ctx->input_offset;
+    m->output_offset = ctx->output_offset;
+    m->schedule = ctx->schedule;
+    m->current_tick = ctx->current_tick;
+    m->gens = ctx->gens;
+    m->literals = ctx->literals;
+    m->literals_tail = ctx->literals_tail;
+    m->dat = ctx->dat;
+    m->out = ctx->out;
+    m->xout = ctx->xout;
+
+    if (ctx->modules_tail) {
+        ctx->modules_tail->n = m;
+    } else {
+        ctx->modules = m;
+    }
+    ctx->modules_tail = m;
+    ctx->module_open = NULL;
+
+    // Start over for the next block
+    ctx->module_name = NULL;
+    ctx->clock_net = NULL;
+    ctx->tick_size = 0;
+    ctx->tick_units = NULL;
+    ctx->use_clk_port = 0;
+    ctx->input_table = NULL;
+    ctx->output_table = NULL;
+    memset(&(ctx->input_syms), 0, sizeof(ctx->input_syms));
+    memset(&(ctx->output_syms), 0, sizeof(ctx->output_syms));
+    ctx->input_offset = 0;
+    ctx->output_offset = 0;
+    ctx->schedule = NULL;
+    ctx->current_tick = -1;
+    ctx->gens = NULL;
+    ctx->literals = NULL;
+    ctx->literals_tail = NULL;
+    memset(&(ctx->dat), 0, sizeof(ctx->dat));
+    memset(&(ctx->out), 0, sizeof(ctx->out));
+    memset(&(ctx->xout), 0, sizeof(ctx->xout));
+
+    if (hashtable_init(&(ctx->input_table)) ||
+        hashtable_init(&(ctx->output_table)) ||
+        schedule_init(&(ctx->schedule))) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "unable to allocate symbol tables");
+        vf_error(ctx);
+    }
+}
+
+
+/**
+ * Check that a source with module blocks has nothing
+ * outside of them
+ *
+ * @param *ctx The compilation context (parsed)
+ * @return none
+ */
+void module_check(vf_ctx_t *ctx) {
+    if (ctx->modules && !_top_is_empty(ctx)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "declarations or statements after the last module block");
+        vf_error(ctx);
+    }
+}
+
+
+/**
+ * Write the outputs of all module blocks, one block per
+ * thread on up to ctx->threads threads (0 = one per
+ * processor). The messages of each block are written out
+ * in the order of the blocks once all of them are done.
+ *
+ * @param *ctx The compilation context (parsed)
+ * @return 0 on success
+ *         1 if any block failed
+ */
+int module_generate(vf_ctx_t *ctx) {
+
+    _module_work_t w;
+    pthread_t *threads;
+    unsigned int i, nthreads;
+    char *running;
+    vf_ctx_t *m;
+    long ncpu;
+
+    memset(&w, 0, sizeof(w));
+    for (m = ctx->modules; m; m = m->n) {
+        ++w.count;
+    }
+    w.mods = malloc(sizeof(*(w.mods)) * w.count);
+    nthreads = ctx->threads;
+    if (!nthreads) {
+        ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = ncpu > 0 ? (unsigned int)ncpu : 1;
+    }
+    if (nthreads > w.count) {
+        nthreads = w.count;
+    }
+    threads = malloc(sizeof(*threads) * nthreads);
+    running = calloc(nthreads, sizeof(*running));
+    if (!w.mods || !threads || !running) {
+        free(w.mods);
+        free(threads);
+        free(running);
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN, "unable to allocate module threads");
+        return 1;
+    }
+    for (i = 0, m = ctx->modules; m; m = m->n) {
+        w.mods[i++] = m;
+    }
+    w.stats = ctx->stats.on;
+
+    // The calling thread writes blocks too
+    for (i = 1; i < nthreads; ++i) {
+        if (pthread_create(&(threads[i]), NULL, _module_worker, &w)) {
+            DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_MAIN,
+                 "unable to start module thread %u", i);
+        } else {
+            running[i] = 1;
+        }
+    }
+    _module_worker(&w);
+    for (i = 1; i < nthreads; ++i) {
+        if (running[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    for (i = 0; i < w.count; ++i) {
+        diag_flush(&(w.mods[i]->diag));
+    }
+
+    free(w.mods);
+    free(threads);
+    free(running);
+    return w.failed;
+}
+
+
+/**
+ * Free the contexts of all module blocks of a source
+ *
+ * @param *ctx The compilation context
+ * @return none
+ */
+void module_free(vf_ctx_t *ctx) {
+
+    vf_ctx_t *m;
+
+    // A block left open by an error
+    if ((m = ctx->module_open)) {
+        m->n = ctx->modules;
+        ctx->modules = m;
+        ctx->module_open = NULL;
+    }
+    while ((m = ctx->modules)) {
+        ctx->modules = m->n;
+        vf_ctx_free(m);
+        free(m);
+    }
+    ctx->modules_tail = NULL;
+}
+
+
+/**
+ * Get the name of an output of a module block, the output
+ * of the whole file with _NAME before its extension
+ *
+ * @param *ctx The compilation context
+ * @param *path The output of the whole file
+ * @param *name The module name
+ * @return The path (in the session arena)
+ */
+static char *_module_path(vf_ctx_t *ctx, const char *path, const char *name) {
+
+    const char *slash = strrchr(path, '/');
+    const char *dot = strrchr(path, '.');
+    size_t stem;
+    char *p;
+
+    if (!dot || (slash && dot < slash) || dot == (slash ? slash + 1 : path)) {
+        dot = path + strlen(path);
+    }
+    stem = dot - path;
+
+    p = arena_alloc(ctx->session_arena, strlen(path) + strlen(name) + 2);
+    if (!p) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "unable to allocate module '%s'", name);
+        vf_error(ctx);
+    }
+    sprintf(p, "%.*s_%s%s", (int)stem, path, name, dot);
+    return p;
+}
+
+
+/**
+ * Check that nothing has been declared or scheduled
+ * outside a module block
+ */
+static int _top_is_empty(vf_ctx_t *ctx) {
+    return !ctx->module_name && !ctx->tick_size &&
+        !ctx->input_syms.count && !ctx->output_syms.count &&
+        !ctx->literals && !ctx->gens && ctx->current_tick < 0;
+}
+
+
+/**
+ * Write the outputs of blocks until none are left
+ *
+ * @param *arg The _module_work_t
+ * @return NULL
+ */
+static void *_module_worker(void *arg) {
+
+    _module_work_t *w = arg;
+    unsigned int i;
+
+    while ((i = __sync_fetch_and_add(&(w->next), 1)) < w->count) {
+        if (_module_run(w->mods[i], w->stats)) {
+            DIAG(&(w->mods[i]->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+                 "failed to write module '%s'", w->mods[i]->module_name);
+            __sync_fetch_and_or(&(w->failed), 1);
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * Write the outputs of one block. Errors in it jump back
+ * here.
+ *
+ * @param *m The context of the block
+ * @param stats Collect statistics of the block
+ * @return 0 on success
+ *         1 on failure
+ */
+static int _module_run(vf_ctx_t *m, int stats) {
+    if (setjmp(m->fail)) {
+        return 1;
+    }
+    if (stats) {
+        stats_start(&(m->stats));
+    }
+    vf_generate(m);
+    return 0;
+}
@@ -0,0 +1,19 @@
+/**
+ * VeriFrog module blocks header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_MODULE_H
+#define VERIFROG_MODULE_H
+
+struct vf_ctx_t;
+
+void module_begin(struct vf_ctx_t *ctx, char *name);
+void module_end(struct vf_ctx_t *ctx);
+void module_check(struct vf_ctx_t *ctx);
+int module_generate(struct vf_ctx_t *ctx);
+void module_free(struct vf_ctx_t *ctx);
+
+#endif
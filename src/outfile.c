@@ -0,0 +1,202 @@
+/**
+ * VeriFrog output files
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "outfile.h"
+
+#define OUTFILE_BUF_SIZE 65536
+#define OUTFILE_TMP_SUFFIX_SIZE 48      // .<pid>.<count>.tmp
+
+static int _same_content(FILE *a, const char *path);
+
+
+/**
+ * Open a temporary file next to the given output path
+ *
+ * @param *o The output file
+ * @param *path The file that is replaced on outfile_close()
+ * @return The temporary file or NULL on failure
+ */
+FILE *outfile_open(outfile_t *o, const char *path) {
+
+    static unsigned int count = 0;
+    int fd;
+
+    o->path = path;
+    o->f = NULL;
+    o->tmp = malloc(strlen(path) + OUTFILE_TMP_SUFFIX_SIZE);
+    if (!o->tmp) {
+        return NULL;
+    }
+
+    // The name is unique to this process and call so that
+    // several threads can write outputs at the same time
+    sprintf(o->tmp, "%s.%ld.%u.tmp", path, (long)getpid(),
+            __sync_fetch_and_add(&count, 1));
+
+    fd = open(o->tmp, O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (fd < 0 || !(o->f = fdopen(fd, "w+"))) {
+        if (fd >= 0) {
+            close(fd);
+            unlink(o->tmp);
+        }
+        free(o->tmp);
+        o->tmp = NULL;
+        return NULL;
+    }
+    return o->f;
+}
+
+
+/**
+ * Finish an output file. If the existing file already has
+ * the same content the temporary file is removed,
+ * otherwise it replaces the existing file.
+ *
+ * @param *o The output file
+ * @return 0 on success
+ *         1 on failure (write error or unable to rename)
+ */
+int outfile_close(outfile_t *o) {
+
+    int err = 0;
+
+    if (!o->f) {
+        return 1;
+    }
+
+    if (fflush(o->f) || ferror(o->f)) {
+        err = 1;
+    } else if (_same_content(o->f, o->path)) {
+        unlink(o->tmp);
+    } else if (rename(o->tmp, o->path)) {
+        err = 1;
+    }
+    fclose(o->f);
+    if (err) {
+        unlink(o->tmp);
+    }
+
+    free(o->tmp);
+    o->tmp = NULL;
+    o->f = NULL;
+    return err;
+}
+
+
+/**
+ * Drop an output file without touching the existing file
+ *
+ * @param *o The output file
+ * @return none
+ */
+void outfile_discard(outfile_t *o) {
+    if (o->f) {
+        fclose(o->f);
+        unlink(o->tmp);
+        free(o->tmp);
+        o->tmp = NULL;
+        o->f = NULL;
+    }
+}
+
+
+/**
+ * Copy a file through an output file (the destination is
+ * only written if its content changes)
+ *
+ * @param *src The file to copy
+ * @param *dst The file to copy to
+ * @return 0 on success
+ *         1 on failure
+ */
+int outfile_copy(const char *src, const char *dst) {
+
+    outfile_t o;
+    FILE *in;
+    char *buf;
+    size_t n;
+
+    in = fopen(src, "rb");
+    if (!in) {
+        return 1;
+    }
+    buf = malloc(OUTFILE_BUF_SIZE);
+    if (!buf || !outfile_open(&o, dst)) {
+        free(buf);
+        fclose(in);
+        return 1;
+    }
+
+    while ((n = fread(buf, 1, OUTFILE_BUF_SIZE, in)) > 0) {
+        fwrite(buf, 1, n, o.f);
+    }
+    if (ferror(in)) {
+        outfile_discard(&o);
+        n = 1;
+    } else {
+        n = outfile_close(&o);
+    }
+
+    free(buf);
+    fclose(in);
+    return (int)n;
+}
+
+
+/**
+ * Compare a (just written) file with the file at a path
+ *
+ * @param *a The open file, its position is changed
+ * @param *path The file to compare with
+ * @return 1 if both files have the same content, 0 otherwise
+ */
+static int _same_content(FILE *a, const char *path) {
+
+    FILE *b;
+    struct stat sa, sb;
+    char *ba, *bb;
+    size_t na, nb;
+    int same = 1;
+
+    if (fstat(fileno(a), &sa) || stat(path, &sb) ||
+        sa.st_size != sb.st_size) {
+        return 0;
+    }
+
+    b = fopen(path, "rb");
+    if (!b) {
+        return 0;
+    }
+    ba = malloc(OUTFILE_BUF_SIZE);
+    bb = malloc(OUTFILE_BUF_SIZE);
+    if (!ba || !bb) {
+        same = 0;
+    }
+
+    rewind(a);
+    while (same) {
+        na = fread(ba, 1, OUTFILE_BUF_SIZE, a);
+        nb = fread(bb, 1, OUTFILE_BUF_SIZE, b);
+        if (na != nb || memcmp(ba, bb, na)) {
+            same = 0;
+        } else if (na == 0) {
+            break;
+        }
+    }
+
+    free(ba);
+    free(bb);
+    fclose(b);
+    return same;
+}
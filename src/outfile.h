@@ -0,0 +1,28 @@
+/**
+ * VeriFrog output file header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_OUTFILE_H
+#define VERIFROG_OUTFILE_H
+
+#include <stdio.h>
+
+// An output file is written to a temporary file next to
+// it and only replaces the real file if its content has
+// changed, leaving unchanged outputs (and their mtimes)
+// untouched.
+typedef struct outfile_t {
+	FILE *f;                        // NULL when not open
+	const char *path;
+	char *tmp;
+} outfile_t;
+
+FILE *outfile_open(outfile_t *o, const char *path);
+int outfile_close(outfile_t *o);
+void outfile_discard(outfile_t *o);
+int outfile_copy(const char *src, const char *dst);
+
+#endif
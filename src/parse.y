@@ -1,9 +1,25 @@
 %code requires {
+#include "bitvec.h"
 #include "varvalpair.h"
 #include "event.h"
+#include "schedule.h"
 #include "symbol.h"
 #include "literal.h"
 #include "verifrog.h"
+#include "gen.h"
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+}
+
+%code provides {
+int yylex(YYSTYPE *yylval_param, yyscan_t yyscanner);
+void yyerror(yyscan_t scanner, vf_ctx_t *ctx, const char *msg);
+void vf_declare_module(vf_ctx_t *ctx, char *name);
+void vf_declare_tick(vf_ctx_t *ctx, char *cnet, int time, char *units, int use_port);
+void vf_declare_net(vf_ctx_t *ctx, char *net, int width, int output);
 }
 
 %{
@@ -11,21 +27,21 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <limits.h>
     
 #include "hashtable.h"
+#include "arena.h"
+#include "datfile.h"
+#include "import.h"
+#include "module.h"
     // Redundant include for using yytoken_kind_t
 #include "parse.tab.h" 
 
-extern void yyerror();
-extern int yylex();
-
 static const char *get_token_name(int); // yysymbol_kind_t
-static void _schedule_event(varval_t *, int, int);
-static event_t *_get_last_event();
-void _insert_xpcts(event_t *, varval_t *);
-void _insert_sets(event_t *, varval_t *);
-
-extern int wval;
+static void _schedule_event(vf_ctx_t *, varval_t *, int, int);
+static void _stream_rows(vf_ctx_t *);
+static void _decls_only(vf_ctx_t *, const char *);
+static int _small(vf_ctx_t *, uint64_t, const char *);
 %}
 
 // Declarations (Optional type definitions)
@@ -33,137 +49,119 @@ extern int wval;
 %union {
     event_t *event;
     char *str;
-    int ival;
+    uint64_t uval;
     varval_t *vv;
+    bitvec_t *bv;
     literal_t *lit;
+    gen_expr_t *expr;
+    long long llval;
 }
 
 // Add args to yyparse and yylex
+%define api.pure full
+%param {yyscan_t scanner}
+%parse-param {vf_ctx_t *ctx}
 %define parse.error custom
 
 // Token defs
-%token<ival> INUM
-%token<str> IDENT VERNUM
+%token<uval> INUM
+%token<str> IDENT
+%token<bv> VERNUM
 %token<lit> LITERAL
 %token TICK UNDEF ALWAYS SET EXPECT IMPLIES 
 %token EQ NEQ INPUT OUTPUT DRAIN ALIAS MODULE
-%token USE
+%token USE REPEAT FOR DOTDOT LSHIFT RSHIFT IMPORT
+%token<str> STRING
+
+%left '|'
+%left '^'
+%left '&'
+%left LSHIFT RSHIFT
+%left '+' '-'
+%left '*' '/' '%'
+%precedence UMINUS
 
 
-%nterm start
+%nterm start stmt stmts
 // %nterm condblk
 %nterm<vv> varval varvalblk
+%nterm<expr> expr
+%nterm<llval> step
 
 // Parsing ruleset definitions
 %%
 start:
     %empty
     {
-        printf("DEBUG: Confuzing empty...\n");
+        DIAG(&(ctx->diag), DIAG_TRACE, DIAG_CAT_PARSE, "Confuzing empty...");
     };
     | start LITERAL
     {
-        // Add literal to list of literals
-        literal_t *l = literals;
-        if (!l) {
-            literals = $2;
+        _decls_only(ctx, "literal");
+
+        // Add literal to end of the list of literals
+        if (!ctx->literals) {
+            ctx->literals = $2;
         } else {
-            while (l && l->n) {
-                l = l->n;
-            }
-            l->n = $2;
+            ctx->literals_tail->n = $2;
         }
+        ctx->literals_tail = $2;
     };
-    | start MODULE IDENT[name]
+    | start IMPORT STRING[file]
     {
-        if (module_name) {
-            printf("ERROR: multiple define module: '%s' on line %d\n",
-                   $name, linenum);
-            yyerror();
+        if (ctx->importing) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "import of '%s' inside import '%s' on line %d",
+                 $file, ctx->importing, ctx->linenum);
+            vf_error(ctx);
         }
-        module_name = $name;
+        import_file(ctx, $file);
+    };
+    | start MODULE IDENT[name]
+    {
+        vf_declare_module(ctx, $name);
+    };
+    | start MODULE IDENT[name] '{' {module_begin(ctx, $name);} start '}'
+    {
+        module_end(ctx);
     };
     | start TICK IDENT[cnet] INUM[time] IDENT[units]
     {
-
-        if (tick_size) {
-            printf("WARN: tick size redefined on line %d\n", linenum);
-        }
-        use_clk_port = 0;
-        clock_net = $cnet;
-        tick_size = $time;
-        tick_units = $units;
+        vf_declare_tick(ctx, $cnet, _small(ctx, $time, "tick length"), $units, 0);
     };
     | start USE TICK IDENT[cnet] INUM[time] IDENT[units]
     {
-        
-        if (tick_size) {
-            printf("WARN: tick size redefined on line %d\n", linenum);
-        }
-        use_clk_port = 1;
-        clock_net = $cnet;
-        tick_size = $time;
-        tick_units = $units;
+        vf_declare_tick(ctx, $cnet, _small(ctx, $time, "tick length"), $units, 1);
     };
     | start INPUT IDENT[net] INUM[width]
     {
-        if (hashtable_contains_skey(input_table, $net)) {
-            printf("WARN: multiple define input net: '%s' on line %d [ignoring...]\n",
-                   $net, linenum);
-        } else {
-            symbol_t *s = malloc(sizeof(*s));
-            if (!s) {
-                printf("ERROR: could not allocate symbol! '%s'\n", $net);
-                yyerror();
-            }
-
-            s->sym = $net;
-            s->width = $width;
-            s->offset = input_offset;
-            hashtable_sput(input_table, $net, s);
-            input_offset += s->width;
-        }
+        vf_declare_net(ctx, $net, _small(ctx, $width, "net width"), 0);
     };
     | start OUTPUT IDENT[net] INUM[width]
     {
-        if (hashtable_contains_skey(output_table, $net)) {
-            printf("WARN: multiple define output net: '%s' on line %d [ignoring...]\n",
-                   $net, linenum);
-        } else {
-            symbol_t *s = malloc(sizeof(*s));
-            if (!s) {
-                printf("ERROR: could not allocate symbol! '%s'\n", $net);
-                yyerror();
-            }
-
-            s->sym = $net;
-            s->width = $width;
-            s->offset = output_offset;
-            hashtable_sput(output_table, $net, s);
-            output_offset += s->width;
-        }
+        vf_declare_net(ctx, $net, _small(ctx, $width, "net width"), 1);
     };
     // | start ALIAS IDENT[new] IDENT[old]
     // {
-        // int i = hashtable_contains_skey(input_table, $new);
-        // int o = hashtable_contains_skey(output_table, $new);
+        // int i = hashtable_contains_skey(ctx->input_table, $new);
+        // int o = hashtable_contains_skey(ctx->output_table, $new);
         // if (i || o) {
             // printf("WARN: multiple define net: '%s' on line %d [ignoring...]\n",
-                   // $new, linenum);
+                   // $new, ctx->linenum);
         // } else {
             // symbol_t *s;
             // if (i) {
-                // s = (symbol_t*)hashtable_sget(input_table, $old);
+                // s = (symbol_t*)hashtable_sget(ctx->input_table, $old);
             // } else {
-                // s = (symbol_t*)hashtable_sget(output_table, $old);
+                // s = (symbol_t*)hashtable_sget(ctx->output_table, $old);
             // }
             
             // if (!s) {
                 // printf("ERROR: Symbol not defined before alias! '%s'\n", $old);
-                // yyerror();
+                // vf_error(ctx);
             // }
 
-            // hashtable_sput(sym_table, $new, s);
+            // hashtable_sput(ctx->sym_table, $new, s);
         // }
     // };
     // | start ALWAYS '{' condblk '}'
@@ -172,23 +170,125 @@ start:
         // printf("ALWAYS");
         // _schedule_event($
     // };
-    | start SET {sym_table = input_table;} '{' varvalblk[vvset] '}'
+    | start {_decls_only(ctx, "statement");} stmt
+    ;
+
+/* Statements that advance time or schedule values. Inside
+   a repeat block they are stored instead of scheduled. */
+stmt:
+    SET {ctx->sym_table = ctx->input_table;} '{' varvalblk[vvset] '}'
     {
-        max_tick = current_tick++;
-        printf("SET (%d)\n", current_tick);
-        _schedule_event($vvset, current_tick, 1);
+        if (ctx->gen_open) {
+            gen_add(ctx, GEN_SET, $vvset, 0);
+        } else {
+            ctx->current_tick++;
+            DIAG(&(ctx->diag), DIAG_DEBUG, DIAG_CAT_PARSE, "SET (%d)", ctx->current_tick);
+            _schedule_event(ctx, $vvset, ctx->current_tick, 1);
+            _stream_rows(ctx);
+        }
     };
-    | start EXPECT {sym_table = output_table;}
+    | EXPECT {ctx->sym_table = ctx->output_table;}
       '(' INUM[vvcycle] ')' '{' varvalblk[vvxpt] '}'
     {
-        printf("EXPECT (%d)\n", current_tick + $vvcycle);
-        _schedule_event($vvxpt, current_tick + $vvcycle, 0);
+        int delay = _small(ctx, $vvcycle, "expect delay");
+
+        if (ctx->gen_open) {
+            gen_add(ctx, GEN_EXPECT, $vvxpt, delay);
+        } else {
+            DIAG(&(ctx->diag), DIAG_DEBUG, DIAG_CAT_PARSE,
+                 "EXPECT (%d)", ctx->current_tick + delay);
+            _schedule_event(ctx, $vvxpt, ctx->current_tick + delay, 0);
+        }
+    };
+    | DRAIN
+    {
+        // The ticks covered by a repeat block must not
+        // depend on what was scheduled before it
+        if (ctx->gen_open) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "drain is not allowed in a repeat block on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        if (!schedule_is_empty(ctx->schedule)) {
+            ctx->current_tick = schedule_last_tick(ctx->schedule);
+        }
+        _stream_rows(ctx);
     };
-    | start DRAIN
+    | REPEAT INUM[count] '{' {gen_begin(ctx, NULL);} stmts '}'
     {
-        current_tick = _get_last_event()->tick;
+        int count = _small(ctx, $count, "repeat count");
+
+        DIAG(&(ctx->diag), DIAG_DEBUG, DIAG_CAT_PARSE, "REPEAT (%d)", count);
+        gen_end(ctx, count, 0, 0);
+        _stream_rows(ctx);
     };
-        
+    | FOR IDENT[var] IDENT[in] INUM[from] DOTDOT INUM[to] step
+      '{'
+      {
+          // 'in' is only a keyword here so nets may use it
+          if (strcmp($in, "in")) {
+              DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                   "expected 'in' after the for variable on line %d", ctx->linenum);
+              vf_error(ctx);
+          }
+          gen_begin(ctx, $var);
+      }
+      stmts '}'
+    {
+        // The range is inclusive and counts down if it ends
+        // below its start. The loop variable is signed, so
+        // the bounds must fit in one.
+        long long span, n;
+
+        if ($from > LLONG_MAX || $to > LLONG_MAX) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "for range too large on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        span = (long long)$to - (long long)$from;
+        n = ((span < 0) ? -span : span) / $step + 1;
+
+        DIAG(&(ctx->diag), DIAG_DEBUG, DIAG_CAT_PARSE, "FOR %s (%llu..%llu step %lld)",
+             $var, (unsigned long long)$from, (unsigned long long)$to, $step);
+        if (n > INT_MAX) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "too many passes of for loop on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        gen_end(ctx, (unsigned int)n, (long long)$from, (span < 0) ? -$step : $step);
+        _stream_rows(ctx);
+    };
+
+step:
+    %empty
+    {
+        $$ = 1;
+    };
+    | IDENT INUM[size]
+    {
+        if (strcmp($1, "step")) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "expected 'step' or '{' after the for range on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        if (!$size) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "for step must be positive on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        if ($size > LLONG_MAX) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "for step too large on line %d", ctx->linenum);
+            vf_error(ctx);
+        }
+        $$ = (long long)$size;
+    };
+
+stmts:
+    %empty
+    | stmts stmt
+    ;
+
 
         
 
@@ -211,46 +311,68 @@ varvalblk:
     };
 
 varval:
-    IDENT '=' VERNUM
+    IDENT '=' expr
     {
-        symbol_t *s = hashtable_sget(sym_table, $1);
+        symbol_t *s = hashtable_sget(ctx->sym_table, $1);
         if (s) {
-            if (s->width != wval) {
-                printf("ERROR: Mismatched vector width (%d != %d) on line %d\n",
-                       wval, s->width, linenum);
-                yyerror();
+            $$ = arena_alloc(ctx->scratch_arena, sizeof(*$$));
+            if (!$$) {
+                DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                     "could not allocate var-val pair on line %d",
+                     ctx->linenum);
+                vf_error(ctx);
             }
-            $$ = malloc(sizeof(*$$));
-            $$->var = $1;
-            $$->val = $3;
+            $$->sym = s;
             $$->n = NULL;
+            gen_varval(ctx, $$, $3);
         } else {
-            printf("ERROR: Unknown net '%s' on line %d.\n",
-                   $1, linenum);
-            yyerror();
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "Unknown net '%s' on line %d.",
+                 $1, ctx->linenum);
+            vf_error(ctx);
         }
     };
 
+/* Values are sized constants, numbers, loop variables and
+   C-like operators on them */
+expr:
+    VERNUM                  { $$ = gen_expr_vec(ctx, $1); };
+    | INUM                  { $$ = gen_expr_const(ctx, $1); };
+    | IDENT                 { $$ = gen_expr_var(ctx, $1); };
+    | '(' expr ')'          { $$ = $2; };
+    | '-' expr %prec UMINUS { $$ = gen_expr(ctx, GEN_EXPR_NEG, $2, NULL); };
+    | '~' expr %prec UMINUS { $$ = gen_expr(ctx, GEN_EXPR_NOT, $2, NULL); };
+    | expr '+' expr         { $$ = gen_expr(ctx, GEN_EXPR_ADD, $1, $3); };
+    | expr '-' expr         { $$ = gen_expr(ctx, GEN_EXPR_SUB, $1, $3); };
+    | expr '*' expr         { $$ = gen_expr(ctx, GEN_EXPR_MUL, $1, $3); };
+    | expr '/' expr         { $$ = gen_expr(ctx, GEN_EXPR_DIV, $1, $3); };
+    | expr '%' expr         { $$ = gen_expr(ctx, GEN_EXPR_MOD, $1, $3); };
+    | expr '&' expr         { $$ = gen_expr(ctx, GEN_EXPR_AND, $1, $3); };
+    | expr '|' expr         { $$ = gen_expr(ctx, GEN_EXPR_OR, $1, $3); };
+    | expr '^' expr         { $$ = gen_expr(ctx, GEN_EXPR_XOR, $1, $3); };
+    | expr LSHIFT expr      { $$ = gen_expr(ctx, GEN_EXPR_SHL, $1, $3); };
+    | expr RSHIFT expr      { $$ = gen_expr(ctx, GEN_EXPR_SHR, $1, $3); };
+
 %%
 
 /**
  * Print an error message
  */
-static int yyreport_syntax_error(const yypcontext_t *ctx) {
-    fprintf(stderr, "\x1b[0;91mSYNTAX ERROR\x1b[0m on line %d\n",
-            linenum);
-    fprintf(stderr,
-            " > DEBUG: comment-level: %d\n", comment_level);
-    fprintf(stderr,
-            " > DEBUG: unexpected token: %s\n",
-            yysymbol_name(yypcontext_token(ctx)));
-
+static int yyreport_syntax_error(const yypcontext_t *pctx, yyscan_t scanner, vf_ctx_t *ctx) {
     // Try to get 1 expected token
     yysymbol_kind_t toks[1];
-    if (!yypcontext_expected_tokens(ctx, toks, 1)) {
-        fprintf(stderr,
-                " > DEBUG: expected: %s\n", get_token_name((int)toks[0]));
+    if (yypcontext_expected_tokens(pctx, toks, 1) > 0) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "syntax error on line %d: unexpected %s, expected %s",
+             ctx->linenum, yysymbol_name(yypcontext_token(pctx)),
+             get_token_name((int)toks[0]));
+    } else {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "syntax error on line %d: unexpected %s",
+             ctx->linenum, yysymbol_name(yypcontext_token(pctx)));
     }
+    DIAG(&(ctx->diag), DIAG_DEBUG, DIAG_CAT_PARSE,
+         "comment-level: %d", ctx->comment_level);
     return 0;
 }
 
@@ -273,161 +395,217 @@ static const char *get_token_name(yysymbol_kind_t sym) {
 /**
  * Enter an event into the scheduler's list
  * 
+ * @param *ctx The compilation context
  * @param *vvl var-val pair list to add
  * @param tick The scheduler tick of the event to modify
  * @param sched_set 1 = SETs
  *                  0 = EXPECTs
  * @return 
  */
-static void _schedule_event(varval_t *vvl, int tick, int sched_set) {
+static void _schedule_event(vf_ctx_t *ctx, varval_t *vvl, int tick, int sched_set) {
 
     // Don't schedule NULL events
     // if (!vvl) {
         // return;
     // }
-    
-    event_t *e;
-    event_t *m = NULL;
 
-    for (e = sch_head; e && e->tick < tick; e = e->n) {
-        /* SEEK */
-    }
+    gen_schedule(ctx, vvl, tick, sched_set, ctx->linenum, ctx->seq++);
 
-    // If an event for this tick does not exist, create a new event
-    if (!e || e->tick != tick) {
-        m = malloc(sizeof(*m));
-        if (!m) {
-            printf("ERROR: failed allocating event (sets)\n");
-            yyerror();
-        }
-        m->tick = tick;
-        m->p = NULL;
-        m->n = NULL;
-        m->sets = NULL;
-        m->xpcts = NULL;
-    }
+    // The var-val list and its values are no longer needed
+    arena_reset(ctx->scratch_arena);
+}
 
-    // If no events in list or none found, create a new one
-    if (!e) {
-        printf("INFO: creating new tick (sets)\n");
-        if (!sch_head) {
-            sch_head = m;
-        } else {
-            event_t *l = _get_last_event();
-            l->n = m;
-            m->p = l;
-        }
-        e = m;
-    }
-    // Otherwise, insert the event
-    else {
-        printf("INFO: updating existing tick (sets)\n");
-        if (e->tick != tick) { // Implies that e->tick > tick
-            if (!e->p) {
-                sch_head = m;
-            }
-                
-            // Insert m before e
-            m->p = e->p;
-            m->n = e;
-            e->p = m;
-            if (m->p) {
-                m->p->n = m;
-            }
-            e = m;
-        }
+
+
+/**
+ * When streaming, write out the rows of all ticks before
+ * the current tick. Later sets and expects can only
+ * schedule at or after the current tick so these rows
+ * are final.
+ * 
+ * @param *ctx The compilation context
+ * @return none
+ */
+static void _stream_rows(vf_ctx_t *ctx) {
+    if (!ctx->stream || schedule_first_tick(ctx->schedule) >= ctx->current_tick) {
+        return;
     }
 
-    // Insert each set into the sets list of the event
-    if (sched_set) {
-        _insert_sets(e, vvl);
-    } else {
-        _insert_xpcts(e, vvl);
+    // Row widths are fixed once the first row is written
+    if (!datfile_is_open(ctx) && datfile_open(ctx, ctx->out.f, ctx->xout.f)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "unable to allocate data file row buffers");
+        vf_error(ctx);
     }
+    STATS_ENTER(&(ctx->stats), STATS_DAT);
+    datfile_emit(ctx, ctx->current_tick);
+    STATS_LEAVE(&(ctx->stats));
 }
 
 
-
 /**
- * Insert all sets from the sets list to the event's sets list
+ * Report a parser error (e.g. memory exhaustion) and
+ * abort the compilation
  * 
- * @param *e The event to which esets should be added
- * @param *sets The sets list
+ * @param scanner The lexer of the compilation
+ * @param *ctx The compilation context
+ * @param *msg The error message
+ * @return Does not return
+ */
+void yyerror(yyscan_t scanner, vf_ctx_t *ctx, const char *msg) {
+    DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE, "%s on line %d", msg, ctx->linenum);
+    vf_error(ctx);
+}
+
+
+
+
+/**
+ * Stop at anything other than a declaration in an import
+ *
+ * @param *ctx The compilation context
+ * @param *what What was found
  * @return none
  */
-void _insert_sets(event_t *e, varval_t *sets) {
-    varval_t *i = sets;
-    varval_t *j, *p, *q;
-    int found = 0;
-    while (i) {
-        printf("SS: %s\n", i->var);
-        for (j = e->sets; j && !found; j = j->n) {
-            if (!strcmp(j->var, i->var)) {
-                printf("WARN: Multiple values for '%s' at time %d on line %d\n",
-                       j->var, e->tick, linenum);
-                found = 1;
-            }
-        }
-        if (!found) {
-            // Insert at beginning of list
-            p = e->sets;
-            e->sets = i;
-            q = i->n;
-            i->n = p;
-            i = q;
-        } else {
-            i = i->n;
-        }
-        found = 0;
+static void _decls_only(vf_ctx_t *ctx, const char *what) {
+    if (ctx->importing) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "%s in import '%s' on line %d, only declarations can be imported",
+             what, ctx->importing, ctx->linenum);
+        vf_error(ctx);
     }
 }
 
 
 /**
- * Insert all xpcts from the xpcts list to the event's xpcts list
- * 
- * @param *e The event to which expcts should be added
- * @param *xpcts The xpcts list
+ * Check that a number used as a count, width or length
+ * fits in an int
+ *
+ * @param *ctx The compilation context
+ * @param val The number
+ * @param *what What the number is, for the message
+ * @return The number
+ */
+static int _small(vf_ctx_t *ctx, uint64_t val, const char *what) {
+    if (val > INT_MAX) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "%s too large (%llu) on line %d", what, (unsigned long long)val,
+             ctx->linenum);
+        vf_error(ctx);
+    }
+    return (int)val;
+}
+
+
+/**
+ * Declare the module under test. Inside a module block
+ * the block names the module, so a declaration of the
+ * same name (e.g. from an imported port file) is allowed.
+ *
+ * @param *ctx The compilation context
+ * @param *name The interned module name
  * @return none
  */
-void _insert_xpcts(event_t *e, varval_t *xpcts) {
-    varval_t *i = xpcts;
-    varval_t *j, *p, *q;
-    int found = 0;
-    while (i) {
-        printf("SS: %s\n", i->var);
-        for (j = e->xpcts; j && !found; j = j->n) {
-            if (!strcmp(j->var, i->var)) {
-                printf("WARN: Multiple values for '%s' at time %d on line %d\n",
-                       j->var, e->tick, linenum);
-                found = 1;
-            }
-        }
-        if (!found) {
-            // Insert at beginning of list
-            p = e->xpcts;
-            e->xpcts = i;
-            q = i->n;
-            i->n = p;
-            i = q;
-        } else {
-            i = i->n;
+void vf_declare_module(vf_ctx_t *ctx, char *name) {
+    if (ctx->importing) {
+        import_record_module(ctx, name);
+    }
+    if (ctx->module_open) {
+        if (strcmp(name, ctx->module_name)) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "module '%s' declared in module block '%s' on line %d",
+                 name, ctx->module_name, ctx->linenum);
+            vf_error(ctx);
         }
-        found = 0;
+        return;
     }
-}
-    
-event_t *_get_last_event() {
-    event_t *i;
-    for (i = sch_head; i && i->n; i = i->n) {
-        /* SEEK */
+    if (ctx->module_name) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "multiple define module: '%s' on line %d",
+             name, ctx->linenum);
+        vf_error(ctx);
     }
-    return i;
+    ctx->module_name = name;
 }
 
-void yyerror() {
-    printf("YYERROR!\n");
-    exit(EXIT_FAILURE);
+
+/**
+ * Declare the length of a tick
+ *
+ * @param *ctx The compilation context
+ * @param *cnet The interned clock net name
+ * @param time The tick length in units
+ * @param *units The interned time units
+ * @param use_port 1 = the clock is a port of the module
+ *                 0 = the test bench makes its own clock
+ * @return none
+ */
+void vf_declare_tick(vf_ctx_t *ctx, char *cnet, int time, char *units, int use_port) {
+    if (ctx->importing) {
+        import_record_tick(ctx, cnet, time, units, use_port);
+    }
+    if (ctx->tick_size) {
+        DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_PARSE,
+             "tick size redefined on line %d", ctx->linenum);
+    }
+    ctx->use_clk_port = use_port;
+    ctx->clock_net = cnet;
+    ctx->tick_size = time;
+    ctx->tick_units = units;
 }
 
 
+/**
+ * Declare an input or output net. Its offset in the data
+ * file rows follows the nets of the same direction
+ * declared before it.
+ *
+ * @param *ctx The compilation context
+ * @param *net The interned net name
+ * @param width The width of the net in bits
+ * @param output 1 = output net
+ *               0 = input net
+ * @return none
+ */
+void vf_declare_net(vf_ctx_t *ctx, char *net, int width, int output) {
+
+    const char *dir = output ? "output" : "input";
+    struct hashtable_t *table = output ? ctx->output_table : ctx->input_table;
+    symbol_list_t *syms = output ? &(ctx->output_syms) : &(ctx->input_syms);
+    int *offset = output ? &(ctx->output_offset) : &(ctx->input_offset);
+    symbol_t *s;
+
+    if (ctx->importing) {
+        import_record_net(ctx, net, width, output);
+    }
+    if (datfile_is_open(ctx)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "%s net '%s' declared after rows were streamed on line %d",
+             dir, net, ctx->linenum);
+        vf_error(ctx);
+    }
+    if (hashtable_contains_skey(table, net)) {
+        DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_PARSE,
+             "multiple define %s net: '%s' on line %d [ignoring...]",
+             dir, net, ctx->linenum);
+        return;
+    }
+
+    s = arena_alloc(ctx->session_arena, sizeof(*s));
+    if (!s) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "could not allocate symbol! '%s'", net);
+        vf_error(ctx);
+    }
+
+    s->sym = net;
+    s->width = width;
+    s->offset = *offset;
+    if (symbol_list_add(syms, s)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+             "could not allocate symbol! '%s'", net);
+        vf_error(ctx);
+    }
+    hashtable_sput(table, net, s);
+    *offset += s->width;
+}
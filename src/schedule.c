@@ -0,0 +1,287 @@
+/**
+ * VeriFrog event scheduler
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdlib.h>
+
+#include "schedule.h"
+
+static int _schedule_grow(schedule_t *s, unsigned int span);
+
+/**
+ * Initialize an empty schedule starting at tick 0
+ * 
+ * @param **s Pointer to the schedule to be allocated
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+int schedule_init(schedule_t **s)
+{
+    (*s) = malloc(sizeof(**s));
+    if (!(*s)) {
+        return 1;
+    }
+    (*s)->size = SCHEDULE_INITIAL_SIZE;
+    (*s)->head = 0;
+    (*s)->count = 0;
+    (*s)->base = 0;
+    (*s)->last = -1;
+    (*s)->pool = NULL;
+    (*s)->ring = calloc((*s)->size, sizeof(*((*s)->ring)));
+
+    if (!(*s)->ring) {
+        free(*s);
+        *s = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * Get the event scheduled for a tick
+ * 
+ * @param *s The schedule to search
+ * @param tick The tick of the event
+ * @return The event at the tick, NULL if there is none
+ */
+event_t *schedule_get(schedule_t *s, int tick)
+{
+    if (!s || tick < s->base || tick > s->last ||
+        (unsigned int)(tick - s->base) >= s->size) {
+        return NULL;
+    }
+    return s->ring[(s->head + (tick - s->base)) & (s->size - 1)];
+}
+
+
+/**
+ * Get the event for a tick, creating an empty event
+ * if the tick does not have one yet.
+ * 
+ * @param *s The schedule to insert into
+ * @param tick The tick of the event. Must not be below
+ *             the first tick of the schedule.
+ * @return The event at the tick, NULL on failure
+ */
+event_t *schedule_insert(schedule_t *s, int tick)
+{
+    event_t *e;
+    event_t **slot;
+    
+    if (!s || tick < s->base) {
+        return NULL;
+    }
+
+    if ((unsigned int)(tick - s->base) >= s->size) {
+        if (_schedule_grow(s, (unsigned int)(tick - s->base) + 1)) {
+            return NULL;
+        }
+    }
+
+    slot = &(s->ring[(s->head + (tick - s->base)) & (s->size - 1)]);
+    if (*slot) {
+        return *slot;
+    }
+
+    // Reuse a released event if there is one
+    if (s->pool) {
+        e = s->pool;
+        s->pool = e->n;
+        event_reset(e, tick);
+    } else {
+        e = event_create(tick);
+        if (!e) {
+            return NULL;
+        }
+    }
+    *slot = e;
+    ++s->count;
+    if (tick > s->last) {
+        s->last = tick;
+    }
+    return e;
+}
+
+
+/**
+ * Remove the first tick from the schedule. The window
+ * then starts one tick later.
+ * 
+ * @param *s The schedule to take the tick from
+ * @return The event at the first tick (NULL for a tick
+ *         without an event). The event must be given back
+ *         with schedule_release() once it is no longer used.
+ */
+event_t *schedule_pop(schedule_t *s)
+{
+    event_t *e;
+    
+    if (!s) {
+        return NULL;
+    }
+
+    e = s->ring[s->head];
+    s->ring[s->head] = NULL;
+    s->head = (s->head + 1) & (s->size - 1);
+    ++s->base;
+    if (e) {
+        --s->count;
+    }
+    return e;
+}
+
+
+/**
+ * Give an event taken with schedule_pop() back to the
+ * schedule. It is kept (with its buffers) for reuse by
+ * a later schedule_insert().
+ * 
+ * @param *s The schedule the event came from
+ * @param *e The event to release
+ * @return none
+ */
+void schedule_release(schedule_t *s, event_t *e)
+{
+    e->n = s->pool;
+    s->pool = e;
+}
+
+
+/**
+ * Extend the schedule up to a tick without giving it an
+ * event. Used for ticks whose events are only created
+ * once their rows are about to be written.
+ * 
+ * @param *s The schedule
+ * @param tick The tick that must be part of the schedule
+ * @return none
+ */
+void schedule_reserve(schedule_t *s, int tick)
+{
+    if (s && tick > s->last) {
+        s->last = tick;
+    }
+}
+
+
+/**
+ * Get the first tick still held by the schedule. All
+ * earlier ticks have been removed with schedule_pop().
+ * 
+ * @param *s The schedule
+ * @return The lowest tick in the window (0 if s is NULL)
+ */
+int schedule_first_tick(schedule_t *s)
+{
+    if (!s) {
+        return 0;
+    }
+    return s->base;
+}
+
+
+/**
+ * Get the tick of the latest event in the schedule
+ * 
+ * @param *s The schedule
+ * @return The highest tick scheduled or reserved, -1 if
+ *         nothing has been scheduled
+ */
+int schedule_last_tick(schedule_t *s)
+{
+    if (!s) {
+        return -1;
+    }
+    return s->last;
+}
+
+
+/**
+ * Returns if the schedule holds no ticks, i.e. all ticks
+ * up to the last scheduled or reserved one have been
+ * removed
+ * 
+ * @param *s The schedule to check
+ * @return 1 if there are no ticks left (or s is NULL)
+ *         0 otherwise
+ */
+unsigned int schedule_is_empty(schedule_t *s)
+{
+    if (s) {
+        return s->base > s->last;
+    }
+    return 1;
+}
+
+
+/**
+ * Free a schedule and every event still held by it. *s will be NULL
+ * following the operation.
+ * 
+ * @param **s Pointer to the schedule to be free'd
+ * @return none
+ */
+void schedule_destroy(schedule_t **s)
+{
+    unsigned int i;
+    event_t *e;
+    
+    if (!s || !(*s)) {
+        return;
+    }
+
+    for (i = 0; i < (*s)->size; ++i) {
+        e = (*s)->ring[i];
+        if (e) {
+            event_destroy(&e);
+        }
+    }
+    while ((*s)->pool) {
+        e = (*s)->pool;
+        (*s)->pool = e->n;
+        event_destroy(&e);
+    }
+    free((*s)->ring);
+    free(*s);
+    *s = NULL;
+}
+
+
+/**
+ * Grow the ring so that it can hold at least span ticks
+ * from the start of the window. Events are unwrapped into
+ * the new ring so that tick 'base' is at index 0.
+ * 
+ * @param *s The schedule to grow
+ * @param span The number of ticks that must fit
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+static int _schedule_grow(schedule_t *s, unsigned int span)
+{
+    unsigned int size = s->size;
+    unsigned int i;
+    event_t **ring;
+
+    while (size < span) {
+        size *= 2;
+    }
+
+    ring = calloc(size, sizeof(*ring));
+    if (!ring) {
+        return 1;
+    }
+
+    for (i = 0; i < s->size; ++i) {
+        ring[i] = s->ring[(s->head + i) & (s->size - 1)];
+    }
+    free(s->ring);
+    s->ring = ring;
+    s->size = size;
+    s->head = 0;
+    return 0;
+}
@@ -0,0 +1,43 @@
+/**
+ * VeriFrog event scheduler header
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_SCHEDULE_H
+#define VERIFROG_SCHEDULE_H
+
+#include "event.h"
+
+#define SCHEDULE_INITIAL_SIZE 64
+
+/*
+ * Events are kept in a circular buffer indexed by tick.
+ * ring[head] holds the event for tick 'base' and every
+ * following slot holds the next tick (NULL for ticks
+ * without an event). The buffer doubles when a tick past
+ * the end of the window is scheduled.
+ */
+typedef struct schedule_t {
+	struct event_t **ring;  // Event slots, one per tick
+	unsigned int size;      // Number of slots in ring (power of 2)
+	unsigned int head;      // Index in ring of tick 'base'
+	unsigned int count;     // Number of events in the schedule
+	int base;               // Lowest tick held in the window
+	int last;               // Highest tick with an event or reserved (-1 if none)
+	struct event_t *pool;   // Released events kept for reuse
+} schedule_t;
+
+int schedule_init(schedule_t **s);
+event_t *schedule_get(schedule_t *s, int tick);
+event_t *schedule_insert(schedule_t *s, int tick);
+event_t *schedule_pop(schedule_t *s);
+void schedule_release(schedule_t *s, event_t *e);
+void schedule_reserve(schedule_t *s, int tick);
+int schedule_first_tick(schedule_t *s);
+int schedule_last_tick(schedule_t *s);
+unsigned int schedule_is_empty(schedule_t *s);
+void schedule_destroy(schedule_t **s);
+
+#endif
@@ -0,0 +1,283 @@
+/**
+ * VeriFrog compile statistics
+ *
+ * Wall clock time is charged to a stack of phases as the
+ * compilation moves between them. The results are printed
+ * as a report, or appended to a file as one JSON object per
+ * line so that the runs of a benchmark, or of different
+ * revisions, can be collected in one place and compared.
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "verifrog.h"
+#include "arena.h"
+#include "datfile.h"
+#include "stats.h"
+
+static double _now(void);
+static void _write_str(FILE *f, const char *s);
+static void _write_table(FILE *f, const char *name, const hashtable_stats_t *t);
+static void _add_table(hashtable_stats_t *sum, struct hashtable_t *table);
+
+static const char *phase_names[STATS_NPHASES] = {
+    "parse", "lex", "sched", "dat", "tb"
+};
+
+static const char *format_names[] = {
+    "bin", "hex", "raw", "rle", "chg"
+};
+
+
+/**
+ * Start collecting statistics. Time is charged to the
+ * parse phase until another phase is entered.
+ *
+ * @param *s The statistics to reset
+ * @return none
+ */
+void stats_start(stats_t *s) {
+    memset(s, 0, sizeof(*s));
+    s->on = 1;
+    s->t = _now();
+    s->stack[0] = STATS_PARSE;
+}
+
+
+/**
+ * Enter a phase. Use STATS_ENTER() instead.
+ *
+ * @param *s The statistics
+ * @param p The phase entered
+ * @return none
+ */
+void stats_enter(stats_t *s, stats_phase_t p) {
+    double t = _now();
+
+    s->phase[s->stack[s->depth]] += t - s->t;
+    s->t = t;
+    if (s->depth < STATS_MAX_DEPTH - 1) {
+        ++s->depth;
+    }
+    s->stack[s->depth] = p;
+}
+
+
+/**
+ * Leave the phase entered last. Use STATS_LEAVE() instead.
+ *
+ * @param *s The statistics
+ * @return none
+ */
+void stats_leave(stats_t *s) {
+    double t = _now();
+
+    s->phase[s->stack[s->depth]] += t - s->t;
+    s->t = t;
+    if (s->depth) {
+        --s->depth;
+    }
+}
+
+
+/**
+ * Stop collecting statistics and record the totals. Must
+ * be called before the context is freed.
+ *
+ * @param *ctx The compilation context
+ * @return none
+ */
+void stats_stop(vf_ctx_t *ctx) {
+
+    stats_t *s = &(ctx->stats);
+    struct rusage ru;
+    vf_ctx_t *m;
+    int i;
+
+    stats_leave(s);
+    s->total = 0;
+    for (i = 0; i < STATS_NPHASES; ++i) {
+        s->total += s->phase[i];
+    }
+
+    // Linux reports kilobytes. This is the peak of the
+    // whole process, not just of this compilation.
+    if (!getrusage(RUSAGE_SELF, &ru)) {
+        s->peak_rss_kb = ru.ru_maxrss;
+    }
+
+    // A cache hit parsed nothing, so there is nothing
+    // else to count
+    if (s->cached) {
+        s->on = 0;
+        return;
+    }
+
+    s->rows = datfile_rows(ctx);
+    s->allocs = ctx->session_arena->allocs + ctx->scratch_arena->allocs;
+    s->arena_bytes = ctx->session_arena->total + ctx->scratch_arena->total;
+    memset(&(s->inputs), 0, sizeof(s->inputs));
+    memset(&(s->outputs), 0, sizeof(s->outputs));
+    if (!ctx->modules) {
+        _add_table(&(s->inputs), ctx->input_table);
+        _add_table(&(s->outputs), ctx->output_table);
+    }
+
+    // The blocks wrote their outputs with statistics of
+    // their own
+    for (m = ctx->modules; m; m = m->n) {
+        s->rows += datfile_rows(m);
+        s->events += m->stats.events;
+        s->varvals += m->stats.varvals;
+        s->empty_ticks += m->stats.empty_ticks;
+        s->bytes += m->stats.bytes;
+        s->allocs += m->session_arena->allocs + m->scratch_arena->allocs;
+        s->arena_bytes += m->session_arena->total + m->scratch_arena->total;
+        _add_table(&(s->inputs), m->input_table);
+        _add_table(&(s->outputs), m->output_table);
+    }
+    s->on = 0;
+}
+
+
+/**
+ * Print the statistics of a compilation to stderr
+ *
+ * @param *ctx The compilation context (statistics stopped)
+ * @return none
+ */
+void stats_print(vf_ctx_t *ctx) {
+
+    const stats_t *s = &(ctx->stats);
+    const hashtable_stats_t *t[2] = {&(s->inputs), &(s->outputs)};
+    const char *tn[2] = {"input_table", "output_table"};
+    int i;
+
+    // Reports of compilations running at the same time
+    // must not interleave
+    flockfile(stderr);
+    fprintf(stderr, "Statistics of '%s'%s:\n", ctx->input_file,
+            s->cached ? " (cached)" : "");
+    for (i = 0; i < STATS_NPHASES; ++i) {
+        fprintf(stderr, "  %-14s %10.6f s %5.1f%%\n", phase_names[i], s->phase[i],
+                s->total > 0 ? 100.0 * s->phase[i] / s->total : 0.0);
+    }
+    fprintf(stderr, "  %-14s %10.6f s\n", "total", s->total);
+    fprintf(stderr, "  %-14s %10lu\n", "rows", s->rows);
+    fprintf(stderr, "  %-14s %10lu\n", "events", s->events);
+    fprintf(stderr, "  %-14s %10lu\n", "varvals", s->varvals);
+    fprintf(stderr, "  %-14s %10lu\n", "empty ticks", s->empty_ticks);
+    fprintf(stderr, "  %-14s %10lu\n", "bytes written", s->bytes);
+    fprintf(stderr, "  %-14s %10lu (%lu bytes held)\n", "allocations",
+            s->allocs, s->arena_bytes);
+    for (i = 0; i < 2; ++i) {
+        fprintf(stderr, "  %-14s %u of %u slots, probes mean %.2f max %u\n",
+                tn[i], t[i]->items, t[i]->slots, t[i]->meanProbe, t[i]->maxProbe);
+    }
+    fprintf(stderr, "  %-14s %10ld kB\n", "peak rss", s->peak_rss_kb);
+    funlockfile(stderr);
+}
+
+
+/**
+ * Append the statistics of a compilation to a file as one
+ * line of JSON
+ *
+ * @param *ctx The compilation context (statistics stopped)
+ * @param *path The file to append to
+ * @return 0 on success
+ *         1 on failure
+ */
+int stats_write_json(vf_ctx_t *ctx, const char *path) {
+
+    const stats_t *s = &(ctx->stats);
+    FILE *f;
+    int i;
+
+    f = fopen(path, "a");
+    if (!f) {
+        return 1;
+    }
+
+    fputs("{\"input\":", f);
+    _write_str(f, ctx->input_file);
+    fprintf(f, ",\"format\":\"%s\",\"stream\":%d,\"sparse\":%d,\"cached\":%d,"
+            "\"rows\":%lu,\"seconds\":{",
+            format_names[ctx->dat_format], ctx->stream, ctx->sparse, s->cached, s->rows);
+    for (i = 0; i < STATS_NPHASES; ++i) {
+        fprintf(f, "\"%s\":%.6f,", phase_names[i], s->phase[i]);
+    }
+    fprintf(f, "\"total\":%.6f},\"events\":%lu,\"varvals\":%lu,\"empty_ticks\":%lu,"
+            "\"bytes\":%lu,\"allocs\":%lu,\"arena_bytes\":%lu,",
+            s->total, s->events, s->varvals, s->empty_ticks, s->bytes, s->allocs,
+            s->arena_bytes);
+    _write_table(f, "input_table", &(s->inputs));
+    _write_table(f, "output_table", &(s->outputs));
+    fprintf(f, "\"peak_rss_kb\":%ld}\n", s->peak_rss_kb);
+
+    return fclose(f) ? 1 : 0;
+}
+
+
+/**
+ * Get the time of a monotonic clock in seconds
+ */
+static double _now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/**
+ * Add the measurements of a symbol table to a sum
+ */
+static void _add_table(hashtable_stats_t *sum, struct hashtable_t *table) {
+    hashtable_stats_t t;
+    unsigned int items;
+
+    hashtable_get_stats(table, &t);
+    items = sum->items + t.items;
+    if (items) {
+        sum->meanProbe = (sum->meanProbe * sum->items + t.meanProbe * t.items) / items;
+    }
+    sum->items = items;
+    sum->slots += t.slots;
+    if (t.maxProbe > sum->maxProbe) {
+        sum->maxProbe = t.maxProbe;
+    }
+}
+
+
+/**
+ * Write the measurements of a table as a JSON member
+ */
+static void _write_table(FILE *f, const char *name, const hashtable_stats_t *t) {
+    fprintf(f, "\"%s\":{\"items\":%u,\"slots\":%u,\"mean_probe\":%.3f,\"max_probe\":%u},",
+            name, t->items, t->slots, t->meanProbe, t->maxProbe);
+}
+
+
+/**
+ * Write a string as a quoted JSON string
+ */
+static void _write_str(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', f);
+            fputc(*s, f);
+        } else if ((unsigned char)*s < 0x20) {
+            fprintf(f, "\\u%04x", (unsigned char)*s);
+        } else {
+            fputc(*s, f);
+        }
+    }
+    fputc('"', f);
+}
@@ -0,0 +1,80 @@
+/**
+ * VeriFrog compile statistics header
+ *
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_STATS_H
+#define VERIFROG_STATS_H
+
+#include <stdio.h>
+
+#include "hashtable.h"
+
+// Phases of a compilation. Time is charged to the phase
+// entered last, so a phase does not include the phases it
+// calls (e.g. scheduling done while writing rows).
+typedef enum stats_phase_t {
+    STATS_PARSE,                    // Everything not in another phase
+    STATS_LEX,
+    STATS_SCHED,
+    STATS_DAT,
+    STATS_TB,
+    STATS_NPHASES
+} stats_phase_t;
+
+#define STATS_MAX_DEPTH 8
+
+typedef struct stats_t {
+	int on;                         // Only collected when set
+	int cached;                     // Outputs copied from the compile cache
+	double t;                       // Time of the last phase change
+	int depth;
+	stats_phase_t stack[STATS_MAX_DEPTH];
+	double phase[STATS_NPHASES];    // Seconds spent in each phase
+	double total;
+	long peak_rss_kb;
+
+	// Counts, kept whether or not statistics are on
+	unsigned long events;           // Ticks entered into the schedule
+	unsigned long varvals;          // Values entered into events
+	unsigned long empty_ticks;      // Rows written for ticks without an event
+	unsigned long bytes;            // Bytes of all output files
+
+	// Filled in by stats_stop(), adding up all module blocks
+	unsigned long rows;             // Rows of the data files
+	unsigned long allocs;           // Arena allocations
+	unsigned long arena_bytes;      // Bytes held by the arenas
+	hashtable_stats_t inputs;       // input_table
+	hashtable_stats_t outputs;      // output_table
+} stats_t;
+
+/*
+ * Enter and leave a phase. Nothing is timed, and the
+ * arguments are not evaluated, unless statistics are on.
+ */
+#define STATS_ENTER(s, p)                                               \
+    do {                                                                \
+        if ((s)->on) {                                                  \
+            stats_enter((s), (p));                                      \
+        }                                                               \
+    } while (0)
+
+#define STATS_LEAVE(s)                                                  \
+    do {                                                                \
+        if ((s)->on) {                                                  \
+            stats_leave(s);                                             \
+        }                                                               \
+    } while (0)
+
+struct vf_ctx_t;
+
+void stats_start(stats_t *s);
+void stats_enter(stats_t *s, stats_phase_t p);
+void stats_leave(stats_t *s);
+void stats_stop(struct vf_ctx_t *ctx);
+void stats_print(struct vf_ctx_t *ctx);
+int stats_write_json(struct vf_ctx_t *ctx, const char *path);
+
+#endif
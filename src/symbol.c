@@ -0,0 +1,48 @@
+/**
+ * VeriFrog Symbol lists
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdlib.h>
+
+#include "symbol.h"
+
+/**
+ * Append a symbol to a list and set its index
+ * 
+ * @param *l The list to append to
+ * @param *s The symbol to append
+ * @return 0 on success
+ *         1 on failure (memory allocation fault)
+ */
+int symbol_list_add(symbol_list_t *l, symbol_t *s) {
+    if (l->count == l->size) {
+        unsigned int size = l->size ? l->size * 2 : 16;
+        symbol_t **syms = realloc(l->syms, sizeof(*syms) * size);
+        if (!syms) {
+            return 1;
+        }
+        l->syms = syms;
+        l->size = size;
+    }
+    s->index = l->count;
+    l->syms[l->count++] = s;
+    return 0;
+}
+
+
+/**
+ * Free the array of a symbol list. The symbols themselves
+ * are not free'd.
+ * 
+ * @param *l The list to free
+ * @return none
+ */
+void symbol_list_free(symbol_list_t *l) {
+    free(l->syms);
+    l->syms = NULL;
+    l->count = 0;
+    l->size = 0;
+}
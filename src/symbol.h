@@ -12,7 +12,18 @@ typedef struct symbol_t {
 	char *sym;
 	int offset; // Bit offset from start of bit vector
 	int width;
+	unsigned int index; // Position in the symbol list of its direction
 } symbol_t;
 
-#endif
+// Symbols of one direction in order of declaration.
+// Events refer to nets by their index in this list.
+typedef struct symbol_list_t {
+	symbol_t **syms;
+	unsigned int count;
+	unsigned int size;
+} symbol_list_t;
+
+int symbol_list_add(symbol_list_t *l, symbol_t *s);
+void symbol_list_free(symbol_list_t *l);
 
+#endif
@@ -0,0 +1,822 @@
+/**
+ * VeriFrog test bench file generation
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hashtable.h"
+#include "literal.h"
+#include "verifrog.h"
+#include "symbol.h"
+#include "datfile.h"
+#include "tbfile.h"
+
+static void _write_stamp(FILE *of);
+static void _write_chg_cases(vf_ctx_t *ctx, FILE *of);
+static int _max_width(symbol_list_t *l, int width);
+
+
+/**
+ * Generate the content of the test bench file
+ * 
+ * @param *ctx The compilation context
+ * @param *of The file to save the test bench to
+ * @return none
+ */
+void generate_tb_file(vf_ctx_t *ctx, FILE *of) {
+
+    //////////////////////////
+    //      File Header     // 
+    //////////////////////////
+
+    // Generate the header. Host, user and time are only
+    // included when asked for so that the same input
+    // always gives the same test bench
+    fprintf(of, "\
+/**\n\
+ * TEST BENCH GENERATED WITH THE VERIFROG TB GENERATOR\n\
+ *\n");
+
+    if (ctx->stamp) {
+        _write_stamp(of);
+    }
+
+    fprintf(of, "\
+ * input file:        %s\n\
+ * test bench file:   %s\n\
+ * data file:         %s\n\
+ *\n\
+ * module under test: %s\n\
+ */\n",
+            ctx->input_file, ctx->tb_file, ctx->dat_file,
+            ctx->module_name
+        );
+
+    //////////////////////////
+    // Module instantiation // 
+    //////////////////////////
+
+    hashtable_itr_t *i;
+    hashtable_entry_t *e;
+    symbol_t *sym;
+    char delim;
+    int it_empty = hashtable_is_empty(ctx->input_table);
+    int ot_empty = hashtable_is_empty(ctx->output_table);
+
+    // Width of the data file rows, without the outputs
+    // when they are in the sparse expect file. Outputs
+    // are then only compared on the ticks with expects.
+    int row_width = ctx->input_offset + (ctx->sparse ? 0 : 2 * ctx->output_offset);
+    int gated = ctx->sparse || ctx->dat_format == DAT_FMT_CHG;
+
+    fprintf(of, "`timescale %d%s/%d%s\n",
+            ctx->tick_size/10,
+            ctx->tick_units,
+            ctx->tick_size/100,
+            ctx->tick_units
+        );
+    fprintf(of, "module tb_%s();\n", ctx->module_name);
+    fprintf(of, "    integer __tick;\n");
+    fprintf(of, "    integer __dat_file;\n");
+    fprintf(of, "    integer __scan_handle;\n");
+    fprintf(of, "    integer __error_count;\n");
+    fprintf(of, "    reg __vfliclk;\n");
+    fprintf(of, "    reg %s;\n", ctx->clock_net);
+    fprintf(of, "    reg [%d:0] __raw_data;\n",
+            ctx->input_offset + (2 * ctx->output_offset) - 1);
+    if (ctx->sparse) {
+        fprintf(of, "    integer __xpct_file;\n");
+        fprintf(of, "    integer __xpct_tick;\n");
+        fprintf(of, "    reg [%d:0] __xpct;\n", (2 * ctx->output_offset) - 1);
+    }
+    if (gated) {
+        fprintf(of, "    reg __check;\n");
+    }
+    switch (ctx->dat_format) {
+    case DAT_FMT_HEX:
+        fprintf(of, "    reg [%d:0] __vectors [0:%u];\n",
+                row_width - 1,
+                datfile_rows(ctx) - 1);
+        break;
+
+    case DAT_FMT_RAW:
+        // $fread fills whole bytes
+        fprintf(of, "    reg [%d:0] __header;\n",
+                (DATFILE_RAW_HEADER_SIZE * 8) - 1);
+        fprintf(of, "    reg [%d:0] __raw_record;\n",
+                (((row_width + 7) / 8) * 8) - 1);
+        break;
+
+    case DAT_FMT_RLE:
+        fprintf(of, "    integer __hold;\n");
+        break;
+
+    case DAT_FMT_CHG:
+        fprintf(of, "    integer __hold;\n");
+        fprintf(of, "    integer __nsets;\n");
+        fprintf(of, "    integer __nxpcts;\n");
+        fprintf(of, "    integer __k;\n");
+        fprintf(of, "    integer __sig;\n");
+        fprintf(of, "    reg [%d:0] __val;\n",
+                _max_width(&(ctx->output_syms), _max_width(&(ctx->input_syms), 1)) - 1);
+        break;
+
+    default:
+        break;
+    }
+    fprintf(of, "    wire [%d:0] __inputs;\n", ctx->input_offset - 1);
+    fprintf(of, "    wire [%d:0] __outputs;\n", ctx->output_offset - 1);
+    fprintf(of, "    assign __inputs = __raw_data[%d:%d];\n",
+            ctx->input_offset - 1,
+            0
+        );
+    
+    // Go through all signals and instantiate them
+    // INPUTS
+    i = hashtable_create_iterator(ctx->input_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up input iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+        fprintf(of, "    wire [%d:0] %s;\n    assign %s = __inputs[%d:%d];\n",
+                sym->width - 1,
+                sym->sym,
+                sym->sym,
+                sym->offset + sym->width - 1,
+                sym->offset
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+    // OUTPUTS
+    i = hashtable_create_iterator(ctx->output_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up output iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+        fprintf(of, "    wire [%d:0] %s;\n    assign __outputs[%d:%d] = %s;\n",
+                sym->width - 1,
+                sym->sym,
+                sym->offset + sym->width - 1,
+                sym->offset,
+                sym->sym
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+
+    //////////////////////////
+    //  LITERAL INCLUSIONS  // 
+    //////////////////////////
+
+    literal_t *l;
+    for (l = ctx->literals; l; l = l->n) {
+        fputs("// LITERAL TEXT BEGIN\n", of);
+        fwrite(l->text, 1, l->len, of);
+        fputs("\n//LITERAL TEXT END\n", of);
+    }
+
+
+    //////////////////////////
+    //   UNIT UNDER TEST    // 
+    //////////////////////////
+
+    // MODULE (UUT)
+    fprintf(of, "    %s UUT(\n", ctx->module_name);
+    
+    if (ctx->use_clk_port) {
+        fprintf(of, "        .%s(%s)%c\n",
+                ctx->clock_net,
+                ctx->clock_net,
+                (ot_empty && it_empty) ? ' ' : ','
+            );
+    }
+    
+    // INPUTS
+    i = hashtable_create_iterator(ctx->input_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up input port iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+
+        if (hashtable_iterator_has_next(i) || !ot_empty) {
+            delim = ',';
+        } else {
+            delim = ' ';
+        }
+        fprintf(of, "        .%s(__inputs[%d:%d])%c\n",
+                sym->sym,
+                sym->offset + sym->width - 1,
+                sym->offset,
+                delim
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+    // OUTPUTS
+    i = hashtable_create_iterator(ctx->output_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up output port iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+
+        if (hashtable_iterator_has_next(i)) {
+            delim = ',';
+        } else {
+            delim = ' ';
+        }
+        fprintf(of, "        .%s(%s)%c\n",
+                sym->sym,
+                sym->sym,
+                delim
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+    // End instantiation
+    fprintf(of, "    );\n");
+
+
+    //////////////////////////
+    //     Clock Setup      // 
+    //////////////////////////
+
+    fprintf(of,
+"\
+    initial begin\n\
+        __vfliclk <= 1'b0;\n\
+        %s <= 1'b0;\n\
+        __tick = 0;\n\
+        __error_count = 0;\n\
+        forever begin\n\
+            #%d __vfliclk <= ~__vfliclk;\n\
+            #%d %s <= __vfliclk;\n\
+            if (__vfliclk == 1'b1) begin\n\
+                __tick = __tick + 1;\n\
+            end\n\
+        end\n\
+    end\n\
+",
+            ctx->clock_net,
+            ctx->tick_size/4,
+            ctx->tick_size/4,
+            ctx->clock_net
+        );
+
+    //////////////////////////
+    //       Stimulus       // 
+    //////////////////////////
+
+    // The next expect record is read ahead so that the
+    // test bench knows on which tick to compare
+    if (ctx->sparse) {
+        fprintf(of,
+"\
+    initial begin\n\
+        __xpct_tick = -1;\n\
+        __xpct_file = $fopen(\"%s\", \"r\");\n\
+        if (__xpct_file == 0) begin\n\
+            $display(\"ERROR: Unable to open expect file\");\n\
+            $finish();\n\
+        end\n\
+        __scan_handle = $fscanf(__xpct_file, \"%%d %%b\\n\", __xpct_tick, __xpct);\n\
+    end\n\
+\n\
+",
+                ctx->xpct_file
+            );
+    }
+
+    switch (ctx->dat_format) {
+    case DAT_FMT_HEX:
+        // The whole data file is loaded once and each
+        // row is indexed by the current tick
+        fprintf(of,
+"\
+    initial begin\n\
+        $readmemh(\"%s\", __vectors);\n\
+    end\n\
+\n\
+    always @(posedge __vfliclk) begin\n\
+        __raw_data = __vectors[__tick];\n\
+",
+                ctx->dat_file
+            );
+        break;
+
+    case DAT_FMT_RAW:
+        // Skip the header, then read one fixed size record
+        // per cycle
+        fprintf(of,
+"\
+    initial begin\n\
+        __dat_file = $fopen(\"%s\", \"rb\");\n\
+        if (__dat_file == 0) begin\n\
+            $display(\"ERROR: Unable to open stimulus file\");\n\
+            $finish();\n\
+        end\n\
+        __scan_handle = $fread(__header, __dat_file);\n\
+    end\n\
+\n\
+    always @(posedge __vfliclk) begin\n\
+        __scan_handle = $fread(__raw_record, __dat_file);\n\
+        __raw_data = __raw_record[%d:0];\n\
+",
+                ctx->dat_file,
+                row_width - 1
+            );
+        break;
+
+    case DAT_FMT_RLE:
+        // A new row is only read once the current one has
+        // been held for its repeat count
+        fprintf(of,
+"\
+    initial begin\n\
+        __hold = 0;\n\
+        __dat_file = $fopen(\"%s\", \"r\");\n\
+        if (__dat_file == 0) begin\n\
+            $display(\"ERROR: Unable to open stimulus file\");\n\
+            $finish();\n\
+        end\n\
+    end\n\
+\n\
+    always @(posedge __vfliclk) begin\n\
+        if (__hold == 0) begin\n\
+            __scan_handle = $fscanf(__dat_file, \"%%d %%b\\n\", __hold, __raw_data);\n\
+        end\n\
+        __hold = __hold - 1;\n\
+",
+                ctx->dat_file
+            );
+        break;
+
+    case DAT_FMT_CHG:
+        // Only the signals listed for a tick are updated.
+        // The inputs keep their values, the expects are
+        // cleared every cycle.
+        fprintf(of,
+"\
+    initial begin\n\
+        __raw_data = 0;\n\
+        __hold = -1;\n\
+        __dat_file = $fopen(\"%s\", \"r\");\n\
+        if (__dat_file == 0) begin\n\
+            $display(\"ERROR: Unable to open stimulus file\");\n\
+            $finish();\n\
+        end\n\
+    end\n\
+\n\
+    always @(posedge __vfliclk) begin\n\
+",
+                ctx->dat_file
+            );
+        if (ctx->output_offset) {
+            fprintf(of, "        __raw_data[%d:%d] = 0;\n",
+                    ctx->input_offset + (2 * ctx->output_offset) - 1,
+                    ctx->input_offset
+                );
+        }
+        fprintf(of,
+"\
+        if (__hold < 0) begin\n\
+            __scan_handle = $fscanf(__dat_file, \"%%d %%d %%d\\n\", __hold, __nsets, __nxpcts);\n\
+        end\n\
+        if (__hold == 0) begin\n\
+            for (__k = 0; __k < __nsets + __nxpcts; __k = __k + 1) begin\n\
+                __scan_handle = $fscanf(__dat_file, \"%%d %%b\\n\", __sig, __val);\n\
+                case (__sig)\n\
+");
+        _write_chg_cases(ctx, of);
+        fprintf(of,
+"\
+                default: ;\n\
+                endcase\n\
+            end\n\
+        end\n\
+        __check = __hold == 0 && __nxpcts > 0;\n\
+        __hold = __hold - 1;\n\
+");
+        break;
+
+    case DAT_FMT_BIN:
+    default:
+        fprintf(of,
+"\
+    initial begin\n\
+        __dat_file = $fopen(\"%s\", \"r\");\n\
+        if (__dat_file == 0) begin\n\
+            $display(\"ERROR: Unable to open stimulus file\");\n\
+            $finish();\n\
+        end\n\
+    end\n\
+\n\
+    always @(posedge __vfliclk) begin\n\
+        __scan_handle = $fscanf(__dat_file, \"%%b\\n\", __raw_data);\n\
+",
+                ctx->dat_file
+            );
+        break;
+    }
+
+    // Expects of this tick from the sparse expect file
+    if (ctx->sparse) {
+        fprintf(of,
+"\
+        __check = __tick == __xpct_tick;\n\
+        if (__check) begin\n\
+            __raw_data[%d:%d] = __xpct;\n\
+            __scan_handle = $fscanf(__xpct_file, \"%%d %%b\\n\", __xpct_tick, __xpct);\n\
+        end\n\
+",
+                ctx->input_offset + (ctx->output_offset * 2) - 1,
+                ctx->input_offset
+            );
+    }
+
+    fprintf(of,
+"\
+\n\
+        if (%s(__raw_data[%d:%d] & __outputs) !== __raw_data[%d:%d]%s) begin\n\
+            __error_count = __error_count + 1;\n\
+            $display(\"ERROR: unexpected value! at tick %%0d\", __tick);\n\
+            $display(\"\
+",
+            gated ? "__check && (" : "",
+            ctx->input_offset + (ctx->output_offset * 2) - 1,
+            ctx->input_offset + ctx->output_offset,
+            ctx->input_offset + ctx->output_offset - 1,
+            ctx->input_offset,
+            gated ? ")" : ""
+        );
+
+    // Generate "ERROR" status message
+
+    // Message component of message
+    i = hashtable_create_iterator(ctx->input_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up input status iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+
+        if (hashtable_iterator_has_next(i) || !ot_empty) {
+            delim = ',';
+        } else {
+            delim = ' ';
+        }
+        fprintf(of, "%s: %%b%c ",
+                sym->sym,
+                delim
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+    i = hashtable_create_iterator(ctx->output_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up output status iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+
+        if (hashtable_iterator_has_next(i)) {
+            delim = ',';
+        } else {
+            delim = ' ';
+        }
+        fprintf(of, "%s: %%b%c ",
+                sym->sym,
+                delim
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+    // Net component of message
+    fprintf(of, "\",\n");
+    
+    i = hashtable_create_iterator(ctx->input_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up input net iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+
+        if (hashtable_iterator_has_next(i) || !ot_empty) {
+            delim = ',';
+        } else {
+            delim = ' ';
+        }
+        fprintf(of, "                %s%c\n",
+                sym->sym,
+                delim
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+    // Outputs
+    i = hashtable_create_iterator(ctx->output_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up output net iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+
+        if (hashtable_iterator_has_next(i)) {
+            delim = ',';
+        } else {
+            delim = ' ';
+        }
+        fprintf(of, "                %s%c\n",
+                sym->sym,
+                delim
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+    fprintf(of, "            );\n");
+    
+    //////////////////////////
+    //    Expected Values   // 
+    //////////////////////////
+    
+    // Expected values
+    fprintf(of, "            $display(\"EXPECTED: ");
+    
+    i = hashtable_create_iterator(ctx->output_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up output expected status iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+
+        if (hashtable_iterator_has_next(i)) {
+            delim = ',';
+        } else {
+            delim = ' ';
+        }
+        fprintf(of, "%s: %%b%c ",
+                sym->sym,
+                delim
+            );
+    }
+
+    hashtable_iterator_free(&i);
+    
+    fprintf(of, "\",\n");
+    
+    i = hashtable_create_iterator(ctx->output_table);
+
+    if (!i) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_TBFILE,
+             "unable to set up output net iterator!");
+        vf_error(ctx);
+    }
+
+    while (hashtable_iterator_has_next(i)) {
+        e = hashtable_iterator_next(i);
+        sym = (symbol_t*)e->value;
+
+        if (hashtable_iterator_has_next(i)) {
+            delim = ',';
+        } else {
+            delim = ' ';
+        }
+        fprintf(of, "                __raw_data[%d:%d]%c\n",
+                ctx->input_offset + sym->offset + sym->width - 1,
+                ctx->input_offset + sym->offset,
+                delim
+            );
+    }
+
+    hashtable_iterator_free(&i);
+
+    // End the stimulus check
+    fprintf(of,
+"\
+            );\n\
+            // $stop();\n\
+        end\n\
+\n\
+");
+
+    // Stop after the last row of the data file
+    switch (ctx->dat_format) {
+    case DAT_FMT_HEX:
+    case DAT_FMT_RAW:
+    case DAT_FMT_RLE:
+    case DAT_FMT_CHG:
+        fprintf(of, "        if (__tick == %u) begin\n", datfile_rows(ctx) - 1);
+        break;
+
+    case DAT_FMT_BIN:
+    default:
+        fprintf(of, "        if ($feof(__dat_file)) begin\n");
+        break;
+    }
+    
+    fprintf(of,
+"\
+            if (__error_count == 0) begin\n\
+                $display(\">>> TESTING COMPLETE - PASS <<<\");\n\
+            end\n\
+            else begin\n\
+                $display(\">>> TESTING COMPLETE - FAIL <<<\");\n\
+            end\n\
+            $finish();\n\
+        end\n\
+    end\n\
+"
+        );
+
+    //////////////////////////
+    //       ENDMODULE      // 
+    //////////////////////////
+
+    fprintf(of, "endmodule\n");
+}
+
+
+
+/**
+ * Write the case items that apply one change list line to
+ * __raw_data. Inputs are numbered first, followed by the
+ * outputs (whose expect mask is also set).
+ * 
+ * @param *ctx The compilation context
+ * @param *of The file to save the test bench to
+ * @return none
+ */
+static void _write_chg_cases(vf_ctx_t *ctx, FILE *of) {
+
+    symbol_t *sym;
+    unsigned int k;
+    int lsb;
+
+    for (k = 0; k < ctx->input_syms.count; ++k) {
+        sym = ctx->input_syms.syms[k];
+        fprintf(of, "                %u: __raw_data[%d:%d] = __val[%d:0];\n",
+                k,
+                sym->offset + sym->width - 1,
+                sym->offset,
+                sym->width - 1
+            );
+    }
+
+    for (k = 0; k < ctx->output_syms.count; ++k) {
+        sym = ctx->output_syms.syms[k];
+        lsb = ctx->input_offset + sym->offset;
+        fprintf(of,
+"\
+                %u: begin\n\
+                    __raw_data[%d:%d] = __val[%d:0];\n\
+                    __raw_data[%d:%d] = {%d{1'b1}};\n\
+                end\n\
+",
+                ctx->input_syms.count + k,
+                lsb + sym->width - 1, lsb,
+                sym->width - 1,
+                lsb + ctx->output_offset + sym->width - 1, lsb + ctx->output_offset,
+                sym->width
+            );
+    }
+}
+
+
+/**
+ * Get the widest symbol of a list
+ * 
+ * @param *l The symbol list
+ * @param width The width to start from
+ * @return The larger of width and the widest symbol
+ */
+static int _max_width(symbol_list_t *l, int width) {
+    unsigned int k;
+    for (k = 0; k < l->count; ++k) {
+        if (l->syms[k]->width > width) {
+            width = l->syms[k]->width;
+        }
+    }
+    return width;
+}
+
+
+/**
+ * Write the host, user and time of the run into the
+ * test bench header
+ * 
+ * @param *of The file to save the test bench to
+ * @return none
+ */
+static void _write_stamp(FILE *of) {
+
+    char *env_host, *env_arch;
+    char *user;
+    char time_str[32];
+    time_t rawtime;
+    struct tm timeinfo;
+
+    // Get some info about the system
+    env_host = getenv("HOSTNAME");
+    env_arch = getenv("HOSTTYPE");
+    user = getenv("USER");
+
+    if (!env_host) {
+        // Falback
+        env_host = getenv("NAME");
+        if (!env_host) {
+            env_host = "<unknown>";
+        }
+    }
+    if (!env_arch) {
+        // Fallback
+        env_arch = getenv("MACHTYPE");
+        if (!env_arch) {
+            env_arch = "???";
+        }
+    }
+    if (!user) {
+        // Fallback
+        user = getenv("USERNAME");
+        if (!user) {
+            user = "<unknown>";
+        }
+    }
+    
+    // Get UTC time string (reentrant versions as several
+    // test benches may be generated at the same time)
+    time(&rawtime);
+    gmtime_r(&rawtime, &timeinfo);
+    asctime_r(&timeinfo, time_str);
+
+    fprintf(of, "\
+ * hostname:          %s (%s)\n\
+ * user:              %s\n\
+ * run time:          %s\
+ *\n",
+            env_host, env_arch,
+            user,
+            time_str
+        );
+}
@@ -0,0 +1,17 @@
+/**
+ * VeriFrog test bench file generation header
+ * 
+ * Zach Baldwin
+ * 2026-10-17
+ */
+
+#ifndef VERIFROG_TBFILE_H
+#define VERIFROG_TBFILE_H
+
+#include <stdio.h>
+
+struct vf_ctx_t;
+
+void generate_tb_file(struct vf_ctx_t *ctx, FILE *of);
+
+#endif
@@ -8,13 +8,18 @@
 #ifndef VERIFROG_VARVALPAIR_H
 #define VERIFROG_VARVALPAIR_H
 
+#include "bitvec.h"
+#include "symbol.h"
+
+// Built by the parser for one set/expect block. Nodes and
+// values are allocated from the scratch arena.
 typedef struct varval_t {
-	char *var;
-	char *val; // Could be a string representing an expression!
+	symbol_t *sym;
+	bitvec_t *val;
+	struct gen_expr_t *expr;    // Computes val on each pass of a loop, NULL
+	                            // if val is fixed
 	struct varval_t *n;
 } varval_t;
 
-void varval_destroy(varval_t **vv);
-
 #endif
 
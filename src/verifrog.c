@@ -7,727 +7,632 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <getopt.h>
+#include <sys/stat.h>
 
 #include "hashtable.h"
+#include "arena.h"
+#include "intern.h"
 #include "literal.h"
 #include "verifrog.h"
-#include "varvalpair.h"
 #include "event.h"
+#include "schedule.h"
+#include "gen.h"
+#include "datfile.h"
+#include "tbfile.h"
+#include "batch.h"
+#include "cache.h"
+#include "input.h"
+#include "module.h"
 #include "parse.tab.h"
 #include "lex.yy.h"
 
-unsigned int linenum = 1;
-int comment_level = 0;
-event_t *sch_head = NULL;
-hashtable_t *input_table = NULL;
-hashtable_t *output_table = NULL;
-hashtable_t *sym_table = NULL;
-int table_width = 0;
-int current_tick = -1;
-int max_tick = 0;
-int input_offset = 0;
-int output_offset = 0;
-char *module_name = NULL;
-literal_t *literals = NULL;
-
-char *clock_net = NULL;
-unsigned int tick_size = 0;
-char *tick_units = NULL;
-int use_clk_port = 0;
-
-extern void yyerror();
-
-static void generate_schedule_file(FILE *);
-static void generate_tb_file(FILE *of);
-
-static char *input_file, *dat_file, *tb_file;
+static void usage(const char *prog);
+static int _vf_batch(vf_ctx_t *opts, const char *manifest, unsigned int jobs,
+                     int nfiles, char **files);
+static void _open_output(vf_ctx_t *ctx, outfile_t *o, const char *path);
+static void _close_output(vf_ctx_t *ctx, outfile_t *o);
+static void _report_stats(vf_ctx_t *ctx);
+
+static const struct option long_options[] = {
+    {"stream", no_argument,       NULL, 's'},
+    {"format", required_argument, NULL, 'f'},
+    {"sparse", no_argument,       NULL, 'x'},
+    {"jobs",   required_argument, NULL, 'j'},
+    {"manifest", required_argument, NULL, 'm'},
+    {"cache",  required_argument, NULL, 'c'},
+    {"stamp",  no_argument,       NULL, 't'},
+    {"stats",  no_argument,       NULL, 'T'},
+    {"stats-json", required_argument, NULL, 'S'},
+    {"verbose", no_argument,      NULL, 'v'},
+    {"quiet",  no_argument,       NULL, 'q'},
+    {"diag",   required_argument, NULL, 'd'},
+    {"help",   no_argument,       NULL, 'h'},
+    {NULL,     0,                 NULL, 0}
+};
 
 
 int main ( int argc, char *argv[] )
 {
-    if ( argc < 2 ) {
-        printf("ERROR: need an input file\n");
-        exit(EXIT_FAILURE);
-    }
-            
-    printf("Input file '%s'\n", argv[1]);
-
-    // Setup input file
-    input_file = argv[1];
-    yyin = fopen(input_file, "r");
-
-    if (!yyin) {
-        printf("ERROR: unable to open input file\n");
-        exit(EXIT_FAILURE);
+    int opt;
+    int batch = 0;
+    unsigned int jobs = 1;
+    unsigned long n;
+    char *end;
+    const char *manifest = NULL;
+    vf_ctx_t ctx;
+
+    vf_ctx_init(&ctx);
+
+    while ((opt = getopt_long(argc, argv, "sf:xj:m:c:tTS:vqd:h", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 's':
+            ctx.stream = 1;
+            break;
+        case 'f':
+            if (!strcmp(optarg, "bin")) {
+                ctx.dat_format = DAT_FMT_BIN;
+            } else if (!strcmp(optarg, "hex")) {
+                ctx.dat_format = DAT_FMT_HEX;
+            } else if (!strcmp(optarg, "raw")) {
+                ctx.dat_format = DAT_FMT_RAW;
+            } else if (!strcmp(optarg, "rle")) {
+                ctx.dat_format = DAT_FMT_RLE;
+            } else if (!strcmp(optarg, "chg")) {
+                ctx.dat_format = DAT_FMT_CHG;
+            } else {
+                DIAG(NULL, DIAG_ERROR, DIAG_CAT_MAIN,
+                     "unknown data file format '%s'", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'x':
+            ctx.sparse = 1;
+            break;
+        case 'j':
+            // Only digits: strtoul() would also take a sign,
+            // leading spaces and trailing junk. 0 is one
+            // worker per processor.
+            errno = 0;
+            n = strtoul(optarg, &end, 10);
+            if (optarg[0] < '0' || optarg[0] > '9' || *end || errno || n > UINT_MAX) {
+                DIAG(NULL, DIAG_ERROR, DIAG_CAT_MAIN,
+                     "invalid number of jobs '%s'", optarg);
+                exit(EXIT_FAILURE);
+            }
+            batch = 1;
+            jobs = (unsigned int)n;
+            break;
+        case 'm':
+            batch = 1;
+            manifest = optarg;
+            break;
+        case 'c':
+            ctx.cache_dir = optarg;
+            break;
+        case 't':
+            ctx.stamp = 1;
+            break;
+        case 'T':
+            ctx.stats_text = 1;
+            break;
+        case 'S':
+            ctx.stats_file = optarg;
+            break;
+        case 'v':
+            if (diag_level < DIAG_TRACE) {
+                ++diag_level;
+            }
+            break;
+        case 'q':
+            diag_level = DIAG_ERROR;
+            break;
+        case 'd':
+            if (diag_parse_cats(optarg, &diag_cats)) {
+                DIAG(NULL, DIAG_ERROR, DIAG_CAT_MAIN,
+                     "unknown diagnostics category in '%s'", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'h':
+            usage(argv[0]);
+            exit(EXIT_SUCCESS);
+        default:
+            usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
     }
 
-    // Set up symbol table
-    hashtable_init(&input_table);
-    hashtable_init(&output_table);
-    
-    yyparse();
-
-    if (!module_name) {
-        printf("ERROR: no module defined\n");
-        yyerror();
+    if (batch) {
+        exit(_vf_batch(&ctx, manifest, jobs, argc - optind, argv + optind));
     }
     
-    if (!sch_head) {
-        printf("No events scheduled!\n");
-    } else {
-
-        FILE *of;
-
-        // Generation of event data file
-        if (argc >= 3) {
-            dat_file = argv[2];
-        } else {
-            dat_file = "vf.dat";
-        }
-        
-        of = fopen(dat_file, "w");
-
-        if (!of) {
-            printf("ERROR: Unable to open output file '%s'\n",
-                   dat_file);
-            exit(EXIT_FAILURE);
-        }
-
-        generate_schedule_file(of);
-
-        fclose(of);
-
-        // Generation of test bench file
-        if (argc >= 4) {
-            tb_file = argv[3];
-        } else {
-            tb_file = "tb_vf.v";
-        }
-
-        of = fopen(tb_file, "w");
-
-        if (!of) {
-            printf("ERROR: Unable to open output file '%s'\n",
-                tb_file);
-            exit(EXIT_FAILURE);
-        }
-
-        generate_tb_file(of);
-
-        fclose(of);
+    if ( optind >= argc ) {
+        DIAG(NULL, DIAG_ERROR, DIAG_CAT_MAIN, "need an input file");
+        exit(EXIT_FAILURE);
     }
 
-    // Free symbol table
-    hashtable_itr_t *i = hashtable_create_iterator(input_table);
-    hashtable_entry_t *s;
-    
-    if (!i) {
-        printf("WARN: Unable to create iterator to free input table\n");
-        printf("      Leaking memory...\n");
+    // Input and output file names
+    ctx.input_file = argv[optind];
+    if (argc - optind >= 2) {
+        ctx.dat_file = argv[optind + 1];
     } else {
-        s = hashtable_iterator_next(i);
-        while (s) {
-            free(((symbol_t*)(s->value))->sym);
-            // s is free'd in hash table destroy fn
-            s = hashtable_iterator_next(i);
-        }
+        ctx.dat_file = "vf.dat";
     }
-
-    hashtable_iterator_free(&i);
-
-    i = hashtable_create_iterator(output_table);
-    
-    if (!i) {
-        printf("WARN: Unable to create iterator to free output table\n");
-        printf("      Leaking memory...\n");
+    if (argc - optind >= 3) {
+        ctx.tb_file = argv[optind + 2];
     } else {
-        s = hashtable_iterator_next(i);
-        while (s) {
-            free(((symbol_t*)(s->value))->sym);
-            // s is free'd in hash table destroy fn
-            s = hashtable_iterator_next(i);
-        }
+        ctx.tb_file = "tb_vf.v";
     }
 
-    hashtable_iterator_free(&i);
-
-    // Free hash tables themselves
-    hashtable_destroy(&input_table);
-    hashtable_destroy(&output_table);
+    if (vf_compile(&ctx)) {
+        exit(EXIT_FAILURE);
+    }
 
     exit ( EXIT_SUCCESS );
 }
 
 
 /**
- * Generate the scheduled event table file
+ * Set a context to its default state. The file names
+ * and options can then be filled in before calling
+ * vf_compile()
  * 
- * @param *of File pointer to output file
+ * @param *ctx The context to initialize
  * @return none
  */
-static void generate_schedule_file(FILE *of) {
-
-    printf("Tick = %d %s (%s)\n", tick_size, tick_units, clock_net);
-
-    // Buffers for input and output bit vectors
-    // Note that the set (input) buffer is not reset
-    // after each tick whereas the expect (output)
-    // buffer is. This means signals stay at their set
-    // values until the programmer says otherwise.
-    // Expect values must be explicitly declared in
-    // each expect block
-    char *input_bv  = malloc((sizeof(*input_bv) * input_offset) + 1);
-    char *output_bv = malloc((sizeof(*output_bv) * output_offset) + 1);
-    char *output_mask = malloc((sizeof(*output_mask) * output_offset) + 1);
-    input_bv[input_offset]   = '\0';
-    output_bv[output_offset] = '\0';
-    memset(input_bv, '0', input_offset);
-    
-    // Go through all events and output them to the file
-    varval_t *v, *vt;
-    event_t *et;
-    symbol_t *s;
-    int tick = 0;
-    while(sch_head) {
-
-        // Reset the expect and mask vectors
-        memset(output_bv, '0', output_offset);
-        memset(output_mask, '0', output_offset);
-
-        // Needed so that empty ticks still are generated
-        if (tick == sch_head->tick) {   
-        
-            printf("SCHED: @ %d ticks\n", sch_head->tick);
-            v = sch_head->sets;
-            while (v) {
-                printf("  S - %s = %s;\n",
-                       v->var, v->val);
-                s = (symbol_t*)hashtable_sget(input_table, v->var);
-                printf("    --> %d, %d\n", s->offset, s->width);
-            
-                // Set the characters in the bit vectors
-                memcpy(input_bv + input_offset - (s->width + s->offset),
-                       v->val, s->width);
-            
-                // Free the var-val pair and get the next in the list
-                vt = v->n;
-                varval_destroy(&v);
-                v = vt;
-            }
-            v = sch_head->xpcts;
-            while (v) {
-                printf("  E - %s = %s;\n",
-                       v->var, v->val);
-                s = (symbol_t*)hashtable_sget(output_table, v->var);
-            
-                // Set the characters in the bit vectors
-                memcpy(output_bv + output_offset - (s->width + s->offset),
-                       v->val, s->width);
-            
-                // Set the bits in the expect mask
-                memset(output_mask + output_offset - (s->width + s->offset),
-                       '1', s->width);
-
-                // Free the var-val pair and get the next in the list
-                vt = v->n;
-                varval_destroy(&v);
-                v = vt;
-            }
-
-            // Free the event and get the next
-            et = sch_head->n;
-            event_destroy(&sch_head);
-            sch_head = et;
-        }
-        fprintf(of, "%s_%s_%s\n", output_mask, output_bv, input_bv);
-
-        ++tick;
-    }
+void vf_ctx_init(vf_ctx_t *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->linenum = 1;
+    ctx->current_tick = -1;
+    ctx->dat_format = DAT_FMT_BIN;
 }
 
 
-
 /**
- * Generate the content of the test bench file
+ * Compile the input file of a context into its data
+ * and test bench files. All memory used by the
+ * compilation is released before returning.
  * 
- * @param *of The file to save the test bench to
- * @return none
+ * @param *ctx The context of the compilation
+ * @return 0 on success
+ *         1 on failure (the reason has been printed)
  */
-void generate_tb_file(FILE *of) {
-
-    //////////////////////////
-    //      File Header     // 
-    //////////////////////////
-
-    char *env_host, *env_arch;
-    char *user;
-    char *time_str;
-    time_t rawtime;
-    struct tm *timeinfo;
-
-    // Get some info about the system
-    env_host = getenv("HOSTNAME");
-    env_arch = getenv("HOSTTYPE");
-    user = getenv("USER");
-
-    if (!env_host) {
-        // Falback
-        env_host = getenv("NAME");
-        if (!env_host) {
-            env_host = "<unknown>";
-        }
-    }
-    if (!env_arch) {
-        // Fallback
-        env_arch = getenv("MACHTYPE");
-        if (!env_arch) {
-            env_arch = "???";
-        }
-    }
-    if (!user) {
-        // Fallback
-        user = getenv("USERNAME");
-        if (!user) {
-            user = "<unknown>";
-        }
-    }
-    
-    // Get UTC time string
-    time(&rawtime);
-    timeinfo = gmtime(&rawtime);
-    time_str = asctime(timeinfo);
-
-    // Generate the header
-    fprintf(of, "\
-/**\n\
- * TEST BENCH GENERATED WITH THE VERIFROG TB GENERATOR\n\
- *\n\
- * hostname:          %s (%s)\n\
- * user:              %s\n\
- * run time:          %s\
- *\n\
- * input file:        %s\n\
- * test bench file:   %s\n\
- * data file:         %s\n\
- *\n\
- * module under test: %s\n\
- */\n",
-            env_host, env_arch,
-            user,
-            time_str,
-            input_file, tb_file, dat_file,
-            module_name
-        );
-
-    //////////////////////////
-    // Module instantiation // 
-    //////////////////////////
-
-    hashtable_itr_t *i;
-    hashtable_entry_t *e;
-    symbol_t *sym;
-    char delim;
-    int it_empty = hashtable_is_empty(input_table);
-    int ot_empty = hashtable_is_empty(output_table);
-
-    fprintf(of, "`timescale %d%s/%d%s\n",
-            tick_size/10,
-            tick_units,
-            tick_size/100,
-            tick_units
-        );
-    fprintf(of, "module tb_%s();\n", module_name);
-    fprintf(of, "    integer __tick;\n");
-    fprintf(of, "    integer __dat_file;\n");
-    fprintf(of, "    integer __scan_handle;\n");
-    fprintf(of, "    integer __error_count;\n");
-    fprintf(of, "    reg __vfliclk;\n");
-    fprintf(of, "    reg %s;\n", clock_net);
-    fprintf(of, "    reg [%d:0] __raw_data;\n",
-            input_offset + (2 * output_offset) - 1);
-    fprintf(of, "    wire [%d:0] __inputs;\n", input_offset - 1);
-    fprintf(of, "    wire [%d:0] __outputs;\n", output_offset - 1);
-    fprintf(of, "    assign __inputs = __raw_data[%d:%d];\n",
-            input_offset - 1,
-            0
-        );
-    
-    // Go through all signals and instantiate them
-    // INPUTS
-    i = hashtable_create_iterator(input_table);
+int vf_compile(vf_ctx_t *ctx) {
 
-    if (!i) {
-        printf("ERROR: unable to set up input iterator!\n");
-        yyerror();
-    }
+    uint64_t key = 0;
+    int cached;
 
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
-        fprintf(of, "    wire [%d:0] %s;\n    assign %s = __inputs[%d:%d];\n",
-                sym->width - 1,
-                sym->sym,
-                sym->sym,
-                sym->offset + sym->width - 1,
-                sym->offset
-            );
+    // Any error from here on jumps back here
+    if (setjmp(ctx->fail)) {
+        if (ctx->importing) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_PARSE,
+                 "while parsing import '%s'", ctx->importing);
+        }
+        vf_ctx_free(ctx);
+        diag_flush(&(ctx->diag));
+        return 1;
     }
 
-    hashtable_iterator_free(&i);
-
-    // OUTPUTS
-    i = hashtable_create_iterator(output_table);
+    DIAG(&(ctx->diag), DIAG_INFO, DIAG_CAT_MAIN, "Input file '%s'", ctx->input_file);
 
-    if (!i) {
-        printf("ERROR: unable to set up output iterator!\n");
-        yyerror();
+    // Change lists already only hold the ticks with expects
+    if (ctx->dat_format == DAT_FMT_CHG) {
+        ctx->sparse = 0;
     }
-
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
-        fprintf(of, "    wire [%d:0] %s;\n    assign __outputs[%d:%d] = %s;\n",
-                sym->width - 1,
-                sym->sym,
-                sym->offset + sym->width - 1,
-                sym->offset,
-                sym->sym
-            );
+    if (ctx->sparse) {
+        ctx->xpct_file = malloc(strlen(ctx->dat_file) + sizeof(VF_XPCT_EXT));
+        if (!ctx->xpct_file) {
+            DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+                 "unable to allocate file name");
+            vf_error(ctx);
+        }
+        sprintf(ctx->xpct_file, "%s" VF_XPCT_EXT, ctx->dat_file);
     }
 
-    hashtable_iterator_free(&i);
-
-
-    //////////////////////////
-    //  LITERAL INCLUSIONS  // 
-    //////////////////////////
-
-    literal_t *l;
-    while (literals) {
-        l = literals->n;
-        fprintf(of, "// LITERAL TEXT BEGIN\n%s\n//LITERAL TEXT END\n",
-                literals->text);
-        free(literals->text);
-        free(literals);
-        literals = l;
+    if (ctx->stats_text || ctx->stats_file) {
+        stats_start(&(ctx->stats));
     }
 
-
-    //////////////////////////
-    //   UNIT UNDER TEST    // 
-    //////////////////////////
-
-    // MODULE (UUT)
-    fprintf(of, "    %s UUT(\n", module_name);
-    
-    if (use_clk_port) {
-        fprintf(of, "        .%s(%s)%c\n",
-                clock_net,
-                clock_net,
-                (ot_empty && it_empty) ? ' ' : ','
-            );
+    // Load the source. It is scanned in place, and is kept
+    // until the context is freed so tokens can point into it
+    if (input_open(&(ctx->input), ctx->input_file)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+             "unable to open input file '%s'", ctx->input_file);
+        vf_error(ctx);
     }
-    
-    // INPUTS
-    i = hashtable_create_iterator(input_table);
 
-    if (!i) {
-        printf("ERROR: unable to set up input port iterator!\n");
-        yyerror();
+    // A stamped test bench differs on every run so it
+    // is never cached
+    cached = ctx->cache_dir && !ctx->stamp && !cache_key(ctx, &key);
+    if (cached && !cache_fetch(ctx, key)) {
+        DIAG(&(ctx->diag), DIAG_INFO, DIAG_CAT_MAIN,
+             "Cache hit (%016llx)", (unsigned long long)key);
+        ctx->stats.cached = 1;
+        _report_stats(ctx);
+        vf_ctx_free(ctx);
+        diag_flush(&(ctx->diag));
+        return 0;
     }
 
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
+    // Set up allocators
+    if (arena_init(&(ctx->session_arena)) || arena_init(&(ctx->scratch_arena)) ||
+        intern_init(&(ctx->strings), ctx->session_arena)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+             "unable to allocate memory arenas");
+        vf_error(ctx);
+    }
 
-        if (hashtable_iterator_has_next(i) || !ot_empty) {
-            delim = ',';
-        } else {
-            delim = ' ';
+    // Set up symbol table
+    if (hashtable_init(&(ctx->input_table)) ||
+        hashtable_init(&(ctx->output_table))) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+             "unable to allocate symbol tables");
+        vf_error(ctx);
+    }
+
+    // Set up the event scheduler
+    if (schedule_init(&(ctx->schedule))) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+             "unable to allocate event schedule");
+        vf_error(ctx);
+    }
+
+    // Set up the lexer. Its extra data is the context
+    // so that lexer rules can reach the allocators
+    if (yylex_init_extra(ctx, (yyscan_t *)&(ctx->scanner))) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN, "unable to allocate lexer");
+        vf_error(ctx);
+    }
+    if (!yy_scan_buffer(ctx->input.buf, ctx->input.size + INPUT_PAD, ctx->scanner)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+             "unable to allocate lexer buffer");
+        vf_error(ctx);
+    }
+
+    // When streaming, the parser writes rows to the data
+    // file as soon as their ticks can no longer change
+    if (ctx->stream) {
+        _open_output(ctx, &(ctx->out), ctx->dat_file);
+        if (ctx->sparse) {
+            _open_output(ctx, &(ctx->xout), ctx->xpct_file);
         }
-        fprintf(of, "        .%s(__inputs[%d:%d])%c\n",
-                sym->sym,
-                sym->offset + sym->width - 1,
-                sym->offset,
-                delim
-            );
     }
-
-    hashtable_iterator_free(&i);
-
-    // OUTPUTS
-    i = hashtable_create_iterator(output_table);
-
-    if (!i) {
-        printf("ERROR: unable to set up output port iterator!\n");
-        yyerror();
+    
+    if (yyparse(ctx->scanner, ctx)) {
+        vf_error(ctx);
+    }
+
+    if (ctx->modules) {
+        // The module blocks write their own outputs, all at
+        // the same time. They are not cached, and the time
+        // is charged to the test bench phase.
+        module_check(ctx);
+        STATS_ENTER(&(ctx->stats), STATS_TB);
+        if (module_generate(ctx)) {
+            vf_error(ctx);
+        }
+        STATS_LEAVE(&(ctx->stats));
+    } else if (!vf_generate(ctx) && cached) {
+        cache_store(ctx, key);
     }
 
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
-
-        if (hashtable_iterator_has_next(i)) {
-            delim = ',';
-        } else {
-            delim = ' ';
-        }
-        fprintf(of, "        .%s(%s)%c\n",
-                sym->sym,
-                sym->sym,
-                delim
-            );
-    }
-
-    hashtable_iterator_free(&i);
-
-    // End instantiation
-    fprintf(of, "    );\n");
-
-
-    //////////////////////////
-    //     Clock Setup      // 
-    //////////////////////////
-
-    fprintf(of,
-"\
-    initial begin\n\
-        __vfliclk <= 1'b0;\n\
-        %s <= 1'b0;\n\
-        __tick = 0;\n\
-        __error_count = 0;\n\
-        forever begin\n\
-            #%d __vfliclk <= ~__vfliclk;\n\
-            #%d %s <= __vfliclk;\n\
-            if (__vfliclk == 1'b1) begin\n\
-                __tick = __tick + 1;\n\
-            end\n\
-        end\n\
-    end\n\
-",
-            clock_net,
-            tick_size/4,
-            tick_size/4,
-            clock_net
-        );
-
-    //////////////////////////
-    //       Stimulus       // 
-    //////////////////////////
-
-    fprintf(of,
-"\
-    initial begin\n\
-        __dat_file = $fopen(\"%s\", \"r\");\n\
-        if (__dat_file == 0) begin\n\
-            $display(\"ERROR: Unable to open stimulus file\");\n\
-            $finish();\n\
-        end\n\
-    end\n\
-\n\
-    always @(posedge __vfliclk) begin\n\
-        __scan_handle = $fscanf(__dat_file, \"%%b\\n\", __raw_data);\n\
-\n\
-        if ((__raw_data[%d:%d] & __outputs) !== __raw_data[%d:%d]) begin\n\
-            __error_count = __error_count + 1;\n\
-            $display(\"ERROR: unexpected value! at tick %%0d\", __tick);\n\
-            $display(\"\
-",
-            dat_file,
-            input_offset + (output_offset * 2) - 1,
-            input_offset + output_offset,
-            input_offset + output_offset - 1,
-            input_offset
-        );
+    _report_stats(ctx);
+    vf_ctx_free(ctx);
+    diag_flush(&(ctx->diag));
+    return 0;
+}
 
-    // Generate "ERROR" status message
 
-    // Message component of message
-    i = hashtable_create_iterator(input_table);
+/**
+ * Write the data and test bench files of a parsed module
+ *
+ * @param *ctx The compilation context (parsed)
+ * @return 0 if the files were written
+ *         1 if there were no events to write
+ */
+int vf_generate(vf_ctx_t *ctx) {
 
-    if (!i) {
-        printf("ERROR: unable to set up input status iterator!\n");
-        yyerror();
+    if (!ctx->module_name) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN, "no module defined");
+        vf_error(ctx);
     }
 
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
-
-        if (hashtable_iterator_has_next(i) || !ot_empty) {
-            delim = ',';
-        } else {
-            delim = ' ';
+    if (ctx->stream) {
+        // Write out the ticks still pending at the end of the input
+        if (!datfile_is_open(ctx) && !schedule_is_empty(ctx->schedule)) {
+            if (datfile_open(ctx, ctx->out.f, ctx->xout.f)) {
+                DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+                     "unable to allocate data file row buffers");
+                vf_error(ctx);
+            }
+        }
+        STATS_ENTER(&(ctx->stats), STATS_DAT);
+        datfile_close(ctx);
+        STATS_LEAVE(&(ctx->stats));
+        _close_output(ctx, &(ctx->out));
+        if (ctx->sparse) {
+            _close_output(ctx, &(ctx->xout));
         }
-        fprintf(of, "%s: %%b%c ",
-                sym->sym,
-                delim
-            );
-    }
-
-    hashtable_iterator_free(&i);
-
-    i = hashtable_create_iterator(output_table);
-
-    if (!i) {
-        printf("ERROR: unable to set up output status iterator!\n");
-        yyerror();
     }
-
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
-
-        if (hashtable_iterator_has_next(i)) {
-            delim = ',';
-        } else {
-            delim = ' ';
+    
+    if ((ctx->stream && !datfile_rows(ctx)) ||
+        (!ctx->stream && schedule_is_empty(ctx->schedule))) {
+        DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_MAIN, "No events scheduled for '%s'!",
+             ctx->module_name);
+        return 1;
+    }
+
+    // Generation of event data file
+    if (!ctx->stream) {
+        _open_output(ctx, &(ctx->out), ctx->dat_file);
+        if (ctx->sparse) {
+            _open_output(ctx, &(ctx->xout), ctx->xpct_file);
         }
-        fprintf(of, "%s: %%b%c ",
-                sym->sym,
-                delim
-            );
+        STATS_ENTER(&(ctx->stats), STATS_DAT);
+        generate_schedule_file(ctx, ctx->out.f, ctx->xout.f);
+        _close_output(ctx, &(ctx->out));
+        if (ctx->sparse) {
+            _close_output(ctx, &(ctx->xout));
+        }
+        STATS_LEAVE(&(ctx->stats));
     }
 
-    hashtable_iterator_free(&i);
+    // Generation of test bench file
+    _open_output(ctx, &(ctx->out), ctx->tb_file);
+    STATS_ENTER(&(ctx->stats), STATS_TB);
+    generate_tb_file(ctx, ctx->out.f);
+    _close_output(ctx, &(ctx->out));
+    STATS_LEAVE(&(ctx->stats));
+    return 0;
+}
 
-    // Net component of message
-    fprintf(of, "\",\n");
-    
-    i = hashtable_create_iterator(input_table);
 
-    if (!i) {
-        printf("ERROR: unable to set up input net iterator!\n");
-        yyerror();
-    }
+/**
+ * Abort the compilation of a context. The error message
+ * must already have been printed. Control returns to
+ * vf_compile() which then frees the context.
+ * 
+ * @param *ctx The context of the failed compilation
+ * @return Does not return
+ */
+void vf_error(vf_ctx_t *ctx) {
+    longjmp(ctx->fail, 1);
+}
 
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
 
-        if (hashtable_iterator_has_next(i) || !ot_empty) {
-            delim = ',';
-        } else {
-            delim = ' ';
-        }
-        fprintf(of, "                %s%c\n",
-                sym->sym,
-                delim
-            );
+/**
+ * Start writing an output file of a context. The file only
+ * replaces an existing one on _close_output() if its
+ * content changed.
+ * 
+ * @param *ctx The compilation context
+ * @param *o The output file of the context to use
+ * @param *path The output file name
+ * @return none
+ */
+static void _open_output(vf_ctx_t *ctx, outfile_t *o, const char *path) {
+    if (!outfile_open(o, path)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN, "Unable to open output file '%s'", path);
+        vf_error(ctx);
     }
+}
 
-    hashtable_iterator_free(&i);
 
-    // Outputs
-    i = hashtable_create_iterator(output_table);
+/**
+ * Finish an output file of a context
+ * 
+ * @param *ctx The compilation context
+ * @param *o The output file to finish
+ * @return none
+ */
+static void _close_output(vf_ctx_t *ctx, outfile_t *o) {
+    const char *path = o->path;
+    struct stat st;
 
-    if (!i) {
-        printf("ERROR: unable to set up output net iterator!\n");
-        yyerror();
+    // The size of the file, mapped writes included
+    if (ctx->stats.on && !fflush(o->f) && !fstat(fileno(o->f), &st)) {
+        ctx->stats.bytes += st.st_size;
+    }
+    if (outfile_close(o)) {
+        DIAG(&(ctx->diag), DIAG_ERROR, DIAG_CAT_MAIN,
+             "Unable to write output file '%s'", path);
+        vf_error(ctx);
     }
+}
 
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
 
-        if (hashtable_iterator_has_next(i)) {
-            delim = ',';
-        } else {
-            delim = ' ';
+/**
+ * Stop the statistics of a compilation and report them
+ * as asked for on the command line
+ *
+ * @param *ctx The compilation context
+ * @return none
+ */
+static void _report_stats(vf_ctx_t *ctx) {
+    if (ctx->stats_text || ctx->stats_file) {
+        stats_stop(ctx);
+    }
+    if (ctx->stats_text) {
+        diag_flush(&(ctx->diag));
+        stats_print(ctx);
+    }
+    if (ctx->stats_file) {
+        if (stats_write_json(ctx, ctx->stats_file)) {
+            DIAG(&(ctx->diag), DIAG_WARN, DIAG_CAT_MAIN,
+                 "unable to write statistics to '%s'", ctx->stats_file);
         }
-        fprintf(of, "                %s%c\n",
-                sym->sym,
-                delim
-            );
     }
+}
 
-    hashtable_iterator_free(&i);
-
-    fprintf(of, "            );\n");
-    
-    //////////////////////////
-    //    Expected Values   // 
-    //////////////////////////
-    
-    // Expected values
-    fprintf(of, "            $display(\"EXPECTED: ");
-    
-    i = hashtable_create_iterator(output_table);
 
-    if (!i) {
-        printf("ERROR: unable to set up output expected status iterator!\n");
-        yyerror();
-    }
+/**
+ * Release all resources held by a context. Safe to call
+ * on a partially set up context.
+ * 
+ * @param *ctx The context to free
+ * @return none
+ */
+void vf_ctx_free(vf_ctx_t *ctx) {
+
+    // Module blocks use the identifiers and source text of
+    // the whole file
+    module_free(ctx);
+
+    // Files
+    if (ctx->scanner) {
+        yylex_destroy(ctx->scanner);
+        ctx->scanner = NULL;
+    }
+    if (ctx->import_scanner) {
+        yylex_destroy(ctx->import_scanner);
+        ctx->import_scanner = NULL;
+    }
+    input_close(&(ctx->input));
+    input_close(&(ctx->import_input));
+    ctx->importing = NULL;
+    ctx->imports = NULL;
+    outfile_discard(&(ctx->out));
+    outfile_discard(&(ctx->xout));
+    free(ctx->xpct_file);
+    ctx->xpct_file = NULL;
+
+    // Drop the row buffers without writing further rows
+    ctx->dat.of = NULL;
+    datfile_close(ctx);
+
+    // Free symbol tables
+    hashtable_destroy(&(ctx->input_table));
+    hashtable_destroy(&(ctx->output_table));
+    symbol_list_free(&(ctx->input_syms));
+    symbol_list_free(&(ctx->output_syms));
+
+    gen_free(ctx);
+    schedule_destroy(&(ctx->schedule));
+
+    // Symbols, identifiers and literals are all released
+    // with the arenas
+    intern_destroy(&(ctx->strings));
+    arena_destroy(&(ctx->scratch_arena));
+    arena_destroy(&(ctx->session_arena));
+}
 
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
 
-        if (hashtable_iterator_has_next(i)) {
-            delim = ',';
-        } else {
-            delim = ' ';
+/**
+ * Compile many input files in batch mode
+ * 
+ * @param *opts Context holding the options shared by all inputs
+ * @param *manifest File listing inputs and outputs or NULL
+ * @param jobs Number of worker threads
+ * @param nfiles Number of input files given on the command line
+ * @param **files The input files given on the command line
+ * @return EXIT_SUCCESS if all inputs compiled, EXIT_FAILURE otherwise
+ */
+static int _vf_batch(vf_ctx_t *opts, const char *manifest, unsigned int jobs,
+                     int nfiles, char **files) {
+
+    vf_batch_t b;
+    unsigned int failed;
+    int i;
+
+    memset(&b, 0, sizeof(b));
+    b.dat_format = opts->dat_format;
+    b.stream = opts->stream;
+    b.sparse = opts->sparse;
+    b.stamp = opts->stamp;
+    b.cache_dir = opts->cache_dir;
+    b.stats_text = opts->stats_text;
+    b.stats_file = opts->stats_file;
+
+    if (manifest && batch_add_manifest(&b, manifest)) {
+        batch_free(&b);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < nfiles; ++i) {
+        if (batch_add(&b, files[i], NULL, NULL)) {
+            DIAG(NULL, DIAG_ERROR, DIAG_CAT_MAIN, "unable to allocate batch job");
+            batch_free(&b);
+            return EXIT_FAILURE;
         }
-        fprintf(of, "%s: %%b%c ",
-                sym->sym,
-                delim
-            );
     }
-
-    hashtable_iterator_free(&i);
-    
-    fprintf(of, "\",\n");
-    
-    i = hashtable_create_iterator(output_table);
-
-    if (!i) {
-        printf("ERROR: unable to set up output net iterator!\n");
-        yyerror();
+    if (!b.count) {
+        DIAG(NULL, DIAG_ERROR, DIAG_CAT_MAIN, "need an input file");
+        return EXIT_FAILURE;
     }
 
-    while (hashtable_iterator_has_next(i)) {
-        e = hashtable_iterator_next(i);
-        sym = (symbol_t*)e->value;
+    failed = batch_run(&b, jobs);
+    DIAG(NULL, DIAG_INFO, DIAG_CAT_BATCH,
+         "Compiled %u of %u input files", b.count - failed, b.count);
 
-        if (hashtable_iterator_has_next(i)) {
-            delim = ',';
-        } else {
-            delim = ' ';
-        }
-        fprintf(of, "                __raw_data[%d:%d]%c\n",
-                input_offset + sym->offset + sym->width - 1,
-                input_offset + sym->offset,
-                delim
-            );
-    }
+    batch_free(&b);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
 
-    hashtable_iterator_free(&i);
 
-    // End the stimulus check
-    fprintf(of,
-"\
-            );\n\
-            // $stop();\n\
-        end\n\
+/**
+ * Print the command line usage
+ * 
+ * @param *prog The name of the executable
+ * @return none
+ */
+static void usage(const char *prog) {
+    printf("\
+Usage: %s [options] <input.vfl> [data file] [test bench file]\n\
+       %s [options] -j N [-m manifest] [input.vfl ...]\n\
+\n\
+An input of '-' reads stdin.\n\
 \n\
-        if ($feof(__dat_file)) begin\n\
-            if (__error_count == 0) begin\n\
-                $display(\">>> TESTING COMPLETE - PASS <<<\");\n\
-            end\n\
-            else begin\n\
-                $display(\">>> TESTING COMPLETE - FAIL <<<\");\n\
-            end\n\
-            $finish();\n\
-        end\n\
-    end\n\
-"
-        );
-
-    //////////////////////////
-    //       ENDMODULE      // 
-    //////////////////////////
-
-    fprintf(of, "endmodule\n");
+Options:\n\
+  -s, --stream    Write data file rows while parsing. Memory use is\n\
+                  bounded by the longest expect lookahead instead of\n\
+                  the length of the test\n\
+  -f, --format FMT\n\
+                  Data file format:\n\
+                    bin  One binary row per tick read with $fscanf\n\
+                         every cycle (default)\n\
+                    hex  One hex row per tick loaded once with\n\
+                         $readmemh\n\
+                    raw  Binary header and fixed width records\n\
+                         read with $fread\n\
+                    rle  Binary rows with a repeat count. Runs of\n\
+                         identical ticks are held instead of read\n\
+                    chg  Only the inputs that change and the\n\
+                         expects of each tick. The test bench\n\
+                         updates just those signals\n\
+  -x, --sparse    Write the expects to <data file>.exp, one line\n\
+                  per tick that has any, instead of into every\n\
+                  row. Outputs are only compared on those ticks\n\
+  -j, --jobs N    Batch mode: compile every input file on N worker\n\
+                  threads (0 = one per processor). Outputs default\n\
+                  to <name>.dat and tb_<name>.v next to each input\n\
+  -m, --manifest FILE\n\
+                  Batch mode: also compile the inputs listed in FILE,\n\
+                  one '<input.vfl> [data file] [test bench file]'\n\
+                  per line\n\
+  -c, --cache DIR Keep outputs in DIR keyed on the input text, the\n\
+                  options, the output names and the compiler\n\
+                  version. Unchanged inputs are not recompiled\n\
+  -t, --stamp     Add host, user and run time to the test bench\n\
+                  header (the output is no longer reproducible and\n\
+                  is not cached)\n\
+  -T, --stats     Print the time spent lexing, parsing, scheduling\n\
+                  and writing each output, counts of events, values,\n\
+                  empty ticks, bytes written and allocations, symbol\n\
+                  table probe lengths and the peak memory use\n\
+  -S, --stats-json FILE\n\
+                  Append the same statistics to FILE as one line of\n\
+                  JSON per compilation\n\
+  -v, --verbose   Show more messages. Repeat for more detail:\n\
+                  -v info, -vv debug, -vvv trace\n\
+  -q, --quiet     Only show errors\n\
+  -d, --diag CATS Only show info and more detailed messages of the\n\
+                  comma separated categories main, lex, parse,\n\
+                  sched, dat, tb, batch (default all)\n\
+  -h, --help      Show this message\n\
+",
+           prog, prog);
 }
-
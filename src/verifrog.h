@@ -1,6 +1,6 @@
 /**
  * VeriFrog language main file header
- * 
+ *
  * Zach Baldwin
  * 2022-10-18
  */
@@ -8,31 +8,128 @@
 #ifndef VERIFROG_H
 #define VERIFROG_H
 
-extern unsigned int linenum;
-extern int comment_level;
-extern struct event_t *sch_head;
-extern hashtable_t *input_table;
-extern hashtable_t *output_table;
-extern hashtable_t *sym_table;
-extern int table_width;
-extern int current_tick;
-extern int max_tick;
-extern int input_offset;
-extern int output_offset;
-extern literal_t *literals;
+#include <stdio.h>
+#include <setjmp.h>
 
-// Module information
-extern char *module_name;
+#include "symbol.h"
+#include "literal.h"
+#include "datfile.h"
+#include "outfile.h"
+#include "diag.h"
+#include "input.h"
+#include "stats.h"
 
-// TB ticks information relative
-// to design's clock
-extern char *clock_net;
-extern unsigned int tick_size;
-extern char *tick_units;
-extern int use_clk_port;
+// Part of the compile cache key, change whenever the
+// generated output changes
+#define VF_VERSION "0.3.0"
 
-// Lookup tables
+// Appended to the data file name to name the sparse
+// expect file
+#define VF_XPCT_EXT ".exp"
 
+// Data file row encoding
+typedef enum dat_format_t {
+    DAT_FMT_BIN,    // Binary text, mask_out_in
+    DAT_FMT_HEX,    // Hex text for $readmemh
+    DAT_FMT_RAW,    // Fixed width binary records for $fread
+    DAT_FMT_RLE,    // Binary text rows with a repeat count
+    DAT_FMT_CHG     // Changed signals of each tick
+} dat_format_t;
 
-#endif
+/*
+ * All state of the compilation of one source file. The
+ * lexer (through yyextra) and the parser (through its
+ * parse parameter) only ever use the context they are
+ * given so several files can be compiled at the same time.
+ */
+typedef struct vf_ctx_t {
+	// Files
+	const char *input_file;
+	const char *dat_file;
+	const char *tb_file;
+	char *xpct_file;                // Sparse expect file or NULL
+	input_t input;                  // Source being parsed
+	outfile_t out;                  // Output file being generated
+	outfile_t xout;                 // Expect file being generated
+	void *scanner;                  // yyscan_t of the reentrant lexer
+
+	// Options
+	dat_format_t dat_format;
+	int stream;                     // Write rows while parsing
+	int sparse;                     // Expects in their own file
+	int stamp;                      // Host, user and time in the TB header
+	const char *cache_dir;          // Compile cache or NULL
+	int stats_text;                 // Print statistics when done
+	const char *stats_file;         // Append statistics as JSON or NULL
+	unsigned int threads;           // Threads writing module blocks, 0 = one per processor
+
+	// Lexer state
+	unsigned int linenum;
+	int comment_level;
+
+	// Symbols
+	struct hashtable_t *input_table;
+	struct hashtable_t *output_table;
+	struct hashtable_t *sym_table;  // Table used by the current block
+	symbol_list_t input_syms;
+	symbol_list_t output_syms;
+	int input_offset;
+	int output_offset;
+
+	// Scheduling
+	struct schedule_t *schedule;
+	int current_tick;
+	struct gen_t *gens;             // Repeat blocks not yet expanded
+	struct gen_block_t *gen_open;   // Repeat block being parsed
+	unsigned int seq;               // Statements scheduled or started so far
+	literal_t *literals;
+	literal_t *literals_tail;
+
+	// Imports
+	const char *importing;          // Import being parsed or NULL
+	struct import_decls_t *import_decls; // Declarations of that import
+	input_t import_input;           // Text of the import being read
+	void *import_scanner;           // yyscan_t of the import being parsed
+	struct import_t *imports;       // All files imported, for the compile cache
+
+	// Module information
+	char *module_name;
 
+	// Module blocks. Each block is moved into a context of
+	// its own when it ends, which then writes its outputs.
+	struct vf_ctx_t *modules;       // Finished blocks in order
+	struct vf_ctx_t *modules_tail;
+	struct vf_ctx_t *module_open;   // Block being parsed
+	struct vf_ctx_t *n;             // Next block of the same file
+
+	// TB ticks information relative
+	// to design's clock
+	char *clock_net;
+	unsigned int tick_size;
+	char *tick_units;
+	int use_clk_port;
+
+	// Data file being written (dat.of is set while
+	// streaming during parsing)
+	datfile_t dat;
+
+	// Allocation
+	struct arena_t *session_arena;  // Lives until the context is free'd
+	struct arena_t *scratch_arena;  // Reset after each scheduled block
+	struct intern_t *strings;       // Identifiers (in session_arena)
+
+	// Messages of this compilation
+	diag_t diag;
+	stats_t stats;
+
+	// Error recovery. vf_error() jumps back to vf_compile()
+	jmp_buf fail;
+} vf_ctx_t;
+
+void vf_ctx_init(vf_ctx_t *ctx);
+int vf_compile(vf_ctx_t *ctx);
+int vf_generate(vf_ctx_t *ctx);
+void vf_ctx_free(vf_ctx_t *ctx);
+void vf_error(vf_ctx_t *ctx);
+
+#endif
@@ -34,7 +34,7 @@
 (setq vfl-font-lock-keywords
       (let* (
             ;; define several category of keywords
-            (x-keywords '("use" "tick" "drain" "alias" "module"))
+            (x-keywords '("use" "tick" "drain" "alias" "module" "import"))
             (x-types '("input" "output"))
             ;; (x-constants '("ACTIVE" "AGENT" "ALL_SIDES" "ATTACH_BACK"))
             (x-events '("@"))
@@ -0,0 +1,110 @@
+/**
+ * TEST BENCH GENERATED WITH THE VERIFROG TB GENERATOR
+ *
+ * input file:        t.vfl
+ * test bench file:   tb_t.v
+ * data file:         t.dat
+ *
+ * module under test: wide_regs
+ */
+`timescale 10ns/1ns
+module tb_wide_regs();
+    integer __tick;
+    integer __dat_file;
+    integer __scan_handle;
+    integer __error_count;
+    reg __vfliclk;
+    reg clk;
+    reg [223:0] __raw_data;
+    integer __xpct_file;
+    integer __xpct_tick;
+    reg [145:0] __xpct;
+    reg __check;
+    wire [77:0] __inputs;
+    wire [72:0] __outputs;
+    assign __inputs = __raw_data[77:0];
+    wire [0:0] bit0;
+    assign bit0 = __inputs[0:0];
+    wire [6:0] odd;
+    assign odd = __inputs[7:1];
+    wire [69:0] word;
+    assign word = __inputs[77:8];
+    wire [69:0] sum;
+    assign __outputs[69:0] = sum;
+    wire [2:0] flag;
+    assign __outputs[72:70] = flag;
+    wide_regs UUT(
+        .clk(clk),
+        .bit0(__inputs[0:0]),
+        .odd(__inputs[7:1]),
+        .word(__inputs[77:8]),
+        .sum(sum),
+        .flag(flag) 
+    );
+    initial begin
+        __vfliclk <= 1'b0;
+        clk <= 1'b0;
+        __tick = 0;
+        __error_count = 0;
+        forever begin
+            #25 __vfliclk <= ~__vfliclk;
+            #25 clk <= __vfliclk;
+            if (__vfliclk == 1'b1) begin
+                __tick = __tick + 1;
+            end
+        end
+    end
+    initial begin
+        __xpct_tick = -1;
+        __xpct_file = $fopen("t.dat.exp", "r");
+        if (__xpct_file == 0) begin
+            $display("ERROR: Unable to open expect file");
+            $finish();
+        end
+        __scan_handle = $fscanf(__xpct_file, "%d %b\n", __xpct_tick, __xpct);
+    end
+
+    initial begin
+        __dat_file = $fopen("t.dat", "r");
+        if (__dat_file == 0) begin
+            $display("ERROR: Unable to open stimulus file");
+            $finish();
+        end
+    end
+
+    always @(posedge __vfliclk) begin
+        __scan_handle = $fscanf(__dat_file, "%b\n", __raw_data);
+        __check = __tick == __xpct_tick;
+        if (__check) begin
+            __raw_data[223:78] = __xpct;
+            __scan_handle = $fscanf(__xpct_file, "%d %b\n", __xpct_tick, __xpct);
+        end
+
+        if (__check && ((__raw_data[223:151] & __outputs) !== __raw_data[150:78])) begin
+            __error_count = __error_count + 1;
+            $display("ERROR: unexpected value! at tick %0d", __tick);
+            $display("bit0: %b, odd: %b, word: %b, sum: %b, flag: %b  ",
+                bit0,
+                odd,
+                word,
+                sum,
+                flag 
+            );
+            $display("EXPECTED: sum: %b, flag: %b  ",
+                __raw_data[147:78],
+                __raw_data[150:148] 
+            );
+            // $stop();
+        end
+
+        if ($feof(__dat_file)) begin
+            if (__error_count == 0) begin
+                $display(">>> TESTING COMPLETE - PASS <<<");
+            end
+            else begin
+                $display(">>> TESTING COMPLETE - FAIL <<<");
+            end
+            $finish();
+        end
+    end
+endmodule
@@ -0,0 +1,119 @@
+/**
+ * TEST BENCH GENERATED WITH THE VERIFROG TB GENERATOR
+ *
+ * input file:        t.vfl
+ * test bench file:   tb_t.v
+ * data file:         t.dat
+ *
+ * module under test: fifo
+ */
+`timescale 10ns/1ns
+module tb_fifo();
+    integer __tick;
+    integer __dat_file;
+    integer __scan_handle;
+    integer __error_count;
+    reg __vfliclk;
+    reg clk;
+    reg [18:0] __raw_data;
+    reg __check;
+    integer __hold;
+    integer __nsets;
+    integer __nxpcts;
+    integer __k;
+    integer __sig;
+    reg [7:0] __val;
+    wire [8:0] __inputs;
+    wire [4:0] __outputs;
+    assign __inputs = __raw_data[8:0];
+    wire [0:0] push;
+    assign push = __inputs[0:0];
+    wire [7:0] data;
+    assign data = __inputs[8:1];
+    wire [0:0] full;
+    assign __outputs[0:0] = full;
+    wire [3:0] level;
+    assign __outputs[4:1] = level;
+    fifo UUT(
+        .clk(clk),
+        .push(__inputs[0:0]),
+        .data(__inputs[8:1]),
+        .full(full),
+        .level(level) 
+    );
+    initial begin
+        __vfliclk <= 1'b0;
+        clk <= 1'b0;
+        __tick = 0;
+        __error_count = 0;
+        forever begin
+            #25 __vfliclk <= ~__vfliclk;
+            #25 clk <= __vfliclk;
+            if (__vfliclk == 1'b1) begin
+                __tick = __tick + 1;
+            end
+        end
+    end
+    initial begin
+        __raw_data = 0;
+        __hold = -1;
+        __dat_file = $fopen("t.dat", "r");
+        if (__dat_file == 0) begin
+            $display("ERROR: Unable to open stimulus file");
+            $finish();
+        end
+    end
+
+    always @(posedge __vfliclk) begin
+        __raw_data[18:9] = 0;
+        if (__hold < 0) begin
+            __scan_handle = $fscanf(__dat_file, "%d %d %d\n", __hold, __nsets, __nxpcts);
+        end
+        if (__hold == 0) begin
+            for (__k = 0; __k < __nsets + __nxpcts; __k = __k + 1) begin
+                __scan_handle = $fscanf(__dat_file, "%d %b\n", __sig, __val);
+                case (__sig)
+                0: __raw_data[0:0] = __val[0:0];
+                1: __raw_data[8:1] = __val[7:0];
+                2: begin
+                    __raw_data[9:9] = __val[0:0];
+                    __raw_data[14:14] = {1{1'b1}};
+                end
+                3: begin
+                    __raw_data[13:10] = __val[3:0];
+                    __raw_data[18:15] = {4{1'b1}};
+                end
+                default: ;
+                endcase
+            end
+        end
+        __check = __hold == 0 && __nxpcts > 0;
+        __hold = __hold - 1;
+
+        if (__check && ((__raw_data[18:14] & __outputs) !== __raw_data[13:9])) begin
+            __error_count = __error_count + 1;
+            $display("ERROR: unexpected value! at tick %0d", __tick);
+            $display("push: %b, data: %b, full: %b, level: %b  ",
+                push,
+                data,
+                full,
+                level 
+            );
+            $display("EXPECTED: full: %b, level: %b  ",
+                __raw_data[9:9],
+                __raw_data[13:10] 
+            );
+            // $stop();
+        end
+
+        if (__tick == 26) begin
+            if (__error_count == 0) begin
+                $display(">>> TESTING COMPLETE - PASS <<<");
+            end
+            else begin
+                $display(">>> TESTING COMPLETE - FAIL <<<");
+            end
+            $finish();
+        end
+    end
+endmodule
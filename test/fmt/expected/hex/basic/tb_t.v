@@ -0,0 +1,84 @@
+/**
+ * TEST BENCH GENERATED WITH THE VERIFROG TB GENERATOR
+ *
+ * input file:        t.vfl
+ * test bench file:   tb_t.v
+ * data file:         t.dat
+ *
+ * module under test: counter
+ */
+`timescale 10ns/1ns
+module tb_counter();
+    integer __tick;
+    integer __dat_file;
+    integer __scan_handle;
+    integer __error_count;
+    reg __vfliclk;
+    reg clk;
+    reg [14:0] __raw_data;
+    reg [14:0] __vectors [0:8];
+    wire [4:0] __inputs;
+    wire [4:0] __outputs;
+    assign __inputs = __raw_data[4:0];
+    wire [0:0] en;
+    assign en = __inputs[0:0];
+    wire [3:0] load;
+    assign load = __inputs[4:1];
+    wire [3:0] count;
+    assign __outputs[3:0] = count;
+    wire [0:0] carry;
+    assign __outputs[4:4] = carry;
+    counter UUT(
+        .clk(clk),
+        .en(__inputs[0:0]),
+        .load(__inputs[4:1]),
+        .count(count),
+        .carry(carry) 
+    );
+    initial begin
+        __vfliclk <= 1'b0;
+        clk <= 1'b0;
+        __tick = 0;
+        __error_count = 0;
+        forever begin
+            #25 __vfliclk <= ~__vfliclk;
+            #25 clk <= __vfliclk;
+            if (__vfliclk == 1'b1) begin
+                __tick = __tick + 1;
+            end
+        end
+    end
+    initial begin
+        $readmemh("t.dat", __vectors);
+    end
+
+    always @(posedge __vfliclk) begin
+        __raw_data = __vectors[__tick];
+
+        if ((__raw_data[14:10] & __outputs) !== __raw_data[9:5]) begin
+            __error_count = __error_count + 1;
+            $display("ERROR: unexpected value! at tick %0d", __tick);
+            $display("en: %b, load: %b, count: %b, carry: %b  ",
+                en,
+                load,
+                count,
+                carry 
+            );
+            $display("EXPECTED: count: %b, carry: %b  ",
+                __raw_data[8:5],
+                __raw_data[9:9] 
+            );
+            // $stop();
+        end
+
+        if (__tick == 8) begin
+            if (__error_count == 0) begin
+                $display(">>> TESTING COMPLETE - PASS <<<");
+            end
+            else begin
+                $display(">>> TESTING COMPLETE - FAIL <<<");
+            end
+            $finish();
+        end
+    end
+endmodule
@@ -0,0 +1,88 @@
+/**
+ * TEST BENCH GENERATED WITH THE VERIFROG TB GENERATOR
+ *
+ * input file:        t.vfl
+ * test bench file:   tb_t.v
+ * data file:         t.dat
+ *
+ * module under test: wide_regs
+ */
+`timescale 10ns/1ns
+module tb_wide_regs();
+    integer __tick;
+    integer __dat_file;
+    integer __scan_handle;
+    integer __error_count;
+    reg __vfliclk;
+    reg clk;
+    reg [223:0] __raw_data;
+    reg [223:0] __vectors [0:3];
+    wire [77:0] __inputs;
+    wire [72:0] __outputs;
+    assign __inputs = __raw_data[77:0];
+    wire [0:0] bit0;
+    assign bit0 = __inputs[0:0];
+    wire [6:0] odd;
+    assign odd = __inputs[7:1];
+    wire [69:0] word;
+    assign word = __inputs[77:8];
+    wire [69:0] sum;
+    assign __outputs[69:0] = sum;
+    wire [2:0] flag;
+    assign __outputs[72:70] = flag;
+    wide_regs UUT(
+        .clk(clk),
+        .bit0(__inputs[0:0]),
+        .odd(__inputs[7:1]),
+        .word(__inputs[77:8]),
+        .sum(sum),
+        .flag(flag) 
+    );
+    initial begin
+        __vfliclk <= 1'b0;
+        clk <= 1'b0;
+        __tick = 0;
+        __error_count = 0;
+        forever begin
+            #25 __vfliclk <= ~__vfliclk;
+            #25 clk <= __vfliclk;
+            if (__vfliclk == 1'b1) begin
+                __tick = __tick + 1;
+            end
+        end
+    end
+    initial begin
+        $readmemh("t.dat", __vectors);
+    end
+
+    always @(posedge __vfliclk) begin
+        __raw_data = __vectors[__tick];
+
+        if ((__raw_data[223:151] & __outputs) !== __raw_data[150:78]) begin
+            __error_count = __error_count + 1;
+            $display("ERROR: unexpected value! at tick %0d", __tick);
+            $display("bit0: %b, odd: %b, word: %b, sum: %b, flag: %b  ",
+                bit0,
+                odd,
+                word,
+                sum,
+                flag 
+            );
+            $display("EXPECTED: sum: %b, flag: %b  ",
+                __raw_data[147:78],
+                __raw_data[150:148] 
+            );
+            // $stop();
+        end
+
+        if (__tick == 3) begin
+            if (__error_count == 0) begin
+                $display(">>> TESTING COMPLETE - PASS <<<");
+            end
+            else begin
+                $display(">>> TESTING COMPLETE - FAIL <<<");
+            end
+            $finish();
+        end
+    end
+endmodule
@@ -0,0 +1,226 @@
+#!/bin/sh
+#
+# VeriFrog tests
+#
+# fmt/*.vfl are compiled in every data file format, with
+# and without --sparse and --stream, and the outputs are
+# compared with the ones checked in under fmt/expected/.
+# Streamed outputs must match the unstreamed ones.
+#
+# gen/*.vfl are compiled next to gen/*_flat.vfl, the same
+# test written out by hand, and their outputs must match.
+# A gen/*.vfl without a *_flat.vfl must fail with the
+# message given on its first line as '// error: <text>'.
+#
+# import/*.vfl import the import/*_ports.vfl files and are
+# compared the same way with import/*_flat.vfl, where the
+# declarations are written out. They are compiled in every
+# format with one cache directory: the first format parses
+# the imports and precompiles them, the others load them.
+# Then the imports are edited and the cached outputs must
+# not be used anymore.
+#
+# With TEST_UPDATE=1 the expected outputs are written
+# instead of compared.
+#
+# usage: run.sh <vf>
+#
+# Zach Baldwin
+# 2026-10-17
+
+VF=$1
+DIR=$(cd "$(dirname "$0")" && pwd)
+FORMATS="bin hex raw rle chg"
+
+if [ -z "$VF" ]; then
+    echo "usage: $0 <vf>" >&2
+    exit 1
+fi
+VF=$(cd "$(dirname "$VF")" && pwd)/$(basename "$VF")
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+PASS=0
+FAIL=0
+
+fail() {
+    echo "FAIL: $*"
+    FAIL=$((FAIL + 1))
+}
+
+# Compile a source in an empty directory. File names end
+# up in the test bench, so the outputs always get the
+# same names: t.dat, t.dat.exp and tb_t.v. The files it
+# can import are copied next to it.
+#
+# usage: compile <source> <directory> [options]
+# The shell has no local variables, so these names must
+# not be used by the callers.
+compile() {
+    c_src=$1
+    c_out=$2
+    shift 2
+    rm -rf "$c_out"
+    mkdir -p "$c_out"
+    cp "$c_src" "$c_out/t.vfl"
+    for c_port in "$(dirname "$c_src")"/*_ports.vfl; do
+        [ -f "$c_port" ] && cp "$c_port" "$c_out"
+    done
+    (cd "$c_out" && "$VF" "$@" t.vfl t.dat tb_t.v > log 2>&1)
+    c_status=$?
+    rm -f "$c_out/t.vfl"
+    return $c_status
+}
+
+# A source that must fail with the message on its first
+# line, without leaving outputs behind
+#
+# usage: must_fail <source> <name>
+must_fail() {
+    want=$(sed -n '1s|^// error: ||p' "$1")
+    for stream in "" -s; do
+        what="$2 $stream"
+        if compile "$1" "$WORK/out" $stream; then
+            fail "$what: compiled but should fail"
+        elif ! grep -q "$want" "$WORK/out/log"; then
+            fail "$what: expected '$want', got: $(cat "$WORK/out/log")"
+        elif [ -n "$(ls "$WORK/out" | grep -v -e '^log$' -e '_ports\.vfl$')" ]; then
+            fail "$what: left outputs behind"
+        else
+            PASS=$((PASS + 1))
+        fi
+    done
+}
+
+for src in "$DIR"/fmt/*.vfl; do
+    name=$(basename "$src" .vfl)
+    for fmt in $FORMATS; do
+        for sparse in "" -x; do
+            # Change lists never have a separate expect file
+            exp=$fmt
+            if [ -n "$sparse" ] && [ "$fmt" != chg ]; then
+                exp=$fmt-x
+            fi
+            exp=$DIR/fmt/expected/$exp/$name
+
+            if [ -n "$TEST_UPDATE" ]; then
+                compile "$src" "$exp" -f $fmt $sparse || fail "$name -f $fmt $sparse"
+                rm -f "$exp/log"
+                continue
+            fi
+
+            for stream in "" -s; do
+                what="$name -f $fmt $sparse $stream"
+                if ! compile "$src" "$WORK/out" -f $fmt $sparse $stream; then
+                    fail "$what: $(cat "$WORK/out/log")"
+                    continue
+                fi
+                rm -f "$WORK/out/log"
+                if diff -r "$exp" "$WORK/out" > "$WORK/diff"; then
+                    PASS=$((PASS + 1))
+                else
+                    fail "$what"
+                    cat "$WORK/diff"
+                fi
+            done
+        done
+    done
+done
+
+for src in "$DIR"/gen/*.vfl; do
+    name=$(basename "$src" .vfl)
+    flat=$DIR/gen/${name}_flat.vfl
+    case $name in
+    *_flat)
+        continue
+        ;;
+    esac
+
+    if [ ! -f "$flat" ]; then
+        must_fail "$src" "$name"
+        continue
+    fi
+
+    for fmt in $FORMATS; do
+        for sparse in "" -x; do
+            for stream in "" -s; do
+                what="$name -f $fmt $sparse $stream"
+                if ! compile "$src" "$WORK/loop" -f $fmt $sparse $stream ||
+                   ! compile "$flat" "$WORK/flat" -f $fmt $sparse $stream; then
+                    fail "$what: $(cat "$WORK/loop/log" "$WORK/flat/log" 2>/dev/null)"
+                    continue
+                fi
+                if diff -r -x log "$WORK/flat" "$WORK/loop" > "$WORK/diff"; then
+                    PASS=$((PASS + 1))
+                else
+                    fail "$what"
+                    cat "$WORK/diff"
+                fi
+            done
+        done
+    done
+done
+
+for src in "$DIR"/import/*.vfl; do
+    name=$(basename "$src" .vfl)
+    flat=$DIR/import/${name}_flat.vfl
+    case $name in
+    *_flat|*_ports)
+        continue
+        ;;
+    esac
+
+    if [ ! -f "$flat" ]; then
+        must_fail "$src" "import $name"
+        continue
+    fi
+
+    rm -rf "$WORK/cache"
+    for fmt in $FORMATS; do
+        what="import $name -f $fmt"
+        if ! compile "$src" "$WORK/loop" -v -c "$WORK/cache" -f $fmt ||
+           ! compile "$flat" "$WORK/flat" -f $fmt; then
+            fail "$what: $(cat "$WORK/loop/log" "$WORK/flat/log" 2>/dev/null)"
+            continue
+        fi
+        if [ $fmt = bin ]; then
+            grep -q "Loaded precompiled import" "$WORK/loop/log" &&
+                fail "$what: loaded a precompiled import on the first run"
+        elif ! grep -q "Loaded precompiled import" "$WORK/loop/log"; then
+            fail "$what: did not load the precompiled imports"
+        fi
+        rm "$WORK/loop/log" "$WORK/flat/log"
+        if diff -r "$WORK/flat" "$WORK/loop" > "$WORK/diff"; then
+            PASS=$((PASS + 1))
+        else
+            fail "$what"
+            cat "$WORK/diff"
+        fi
+    done
+
+    # Edit the imports where they are, then compile again
+    # with the cache and without it
+    what="import $name edited"
+    mv "$WORK/loop" "$WORK/edit"
+    for port in "$WORK"/edit/*_ports.vfl; do
+        echo "input edited_$(basename "$port" .vfl) 3" >> "$port"
+    done
+    cp "$src" "$WORK/edit/t.vfl"
+    if ! (cd "$WORK/edit" && "$VF" -c "$WORK/cache" -f chg t.vfl t.dat tb_t.v > log 2>&1); then
+        fail "$what: $(cat "$WORK/edit/log")"
+    else
+        mkdir "$WORK/fresh"
+        cp "$WORK"/edit/*.vfl "$WORK/fresh"
+        (cd "$WORK/fresh" && "$VF" -f chg t.vfl t.dat tb_t.v > log 2>&1)
+        if diff -r -x log "$WORK/fresh" "$WORK/edit" > "$WORK/diff"; then
+            PASS=$((PASS + 1))
+        else
+            fail "$what: cached outputs were used"
+            cat "$WORK/diff"
+        fi
+    fi
+    rm -rf "$WORK/edit" "$WORK/fresh"
+done
+
+echo "$PASS passed, $FAIL failed"
+[ "$FAIL" -eq 0 ]